@@ -0,0 +1,100 @@
+// Inventory contention benchmark
+// Compares one Inventory behind a single mutex with the sharded ConcurrentInventory
+// from 1 to 64 threads. Every thread runs the same add/remove/read mix.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include "inventory.h"
+#include "concurrent_inventory.h"
+
+namespace {
+    const int TOTAL_OPS = 400000;  // Split across the threads of each run
+    const int READ_EVERY = 64;     // One full read (display/export style) per this many writes
+    const int ITEM_KINDS = 256;
+    const int PREFILL = 4096;      // Items already held before the threads start
+
+    // One Inventory guarded by a global mutex, the baseline being replaced
+    struct LockedInventory{
+        std::mutex mutex;
+        Inventory inventory;
+
+        LockedInventory(): inventory(TOTAL_OPS + PREFILL, RemovalPolicy::SWAP_AND_POP) {}
+
+        void add(ItemId item){ std::lock_guard<std::mutex> lock(mutex); inventory += item; }
+        void remove(ItemId item){ std::lock_guard<std::mutex> lock(mutex); inventory -= item; }
+        int read(){
+            std::lock_guard<std::mutex> lock(mutex);
+            int count = 0;
+            for (const std::string& name : inventory) count += !name.empty();
+            return count;
+        }
+    };
+
+    // ConcurrentInventory with the same interface
+    struct ShardedInventory{
+        ConcurrentInventory inventory;
+
+        ShardedInventory(): inventory(TOTAL_OPS + PREFILL, 64) {}
+
+        void add(ItemId item){ inventory.tryAdd(item); }
+        void remove(ItemId item){ inventory.tryRemove(item); }
+        int read(){
+            int count = 0;
+            inventory.snapshot().forEach([&count](ItemId, int quantity){ count += quantity; });
+            return count;
+        }
+    };
+
+    // Run the mix on threadCount threads, returns nanoseconds per operation
+    template<typename Target>
+    double run(int threadCount, const std::vector<ItemId>& ids){
+        Target target;
+        for (int i = 0; i < PREFILL; ++i)
+            target.add(ids[i % ids.size()]);
+        std::atomic<int> sink(0);
+        int opsPerThread = TOTAL_OPS / threadCount;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t){
+            threads.emplace_back([&, t]{
+                int local = 0;
+                for (int i = 0; i < opsPerThread; i += 2){
+                    ItemId id = ids[(i * 31 + t * 17) % ids.size()];
+                    target.add(id);
+                    if (i % READ_EVERY == 0)
+                        local += target.read() > 0; // Read while this thread's item is held
+                    target.remove(id);
+                }
+                sink += local;
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / (opsPerThread * threadCount);
+    }
+}
+
+int main(){
+    std::vector<ItemId> ids;
+    for (int i = 0; i < ITEM_KINDS; ++i)
+        ids.push_back(ItemRegistry::global().intern("Item " + std::to_string(i)));
+
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "mutex ns/op" << std::setw(16) << "sharded ns/op" << std::setw(10) << "speedup" << "\n";
+    for (int threads = 1; threads <= 64; threads *= 2){
+        double locked = run<LockedInventory>(threads, ids);
+        double sharded = run<ShardedInventory>(threads, ids);
+        std::cout << std::setw(8) << threads
+                  << std::setw(16) << std::fixed << std::setprecision(1) << locked
+                  << std::setw(16) << sharded
+                  << std::setw(9) << std::setprecision(2) << locked / sharded << "x\n";
+    }
+    return 0;
+}
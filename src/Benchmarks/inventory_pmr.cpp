@@ -0,0 +1,189 @@
+// Inventory allocation benchmark
+// Builds a zone of inventories and tears it down, once on the global heap
+// and once each on a pool and a monotonic arena from std::pmr. The first row
+// is the unmodified lesson 07_08e class, the baseline the others improve on.
+// The LINEAR rows keep no index, like the baseline; the SWAP_AND_POP rows add
+// the hash index that makes removal O(1), and the allocations it costs.
+// Only the inventories' containers come from the resource: item names are
+// interned once in the ItemRegistry, on the global heap, before any timing.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <memory_resource>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include "inventory.h"
+#include "lesson_inventories.h"
+
+// Count every heap allocation made through operator new, for the baseline row
+namespace {
+    size_t allocationCount = 0;
+}
+
+void* operator new(size_t size){
+    ++allocationCount;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept{
+    std::free(p);
+}
+
+namespace {
+    const int INVENTORIES = 100000;
+    const int ITEMS_PER_INVENTORY = 24;
+    const int ITEM_KINDS = 500;
+
+    // Pass-through resource that counts the blocks it hands out
+    class CountingResource : public std::pmr::memory_resource{
+    public:
+        explicit CountingResource(std::pmr::memory_resource* upstream_i): upstream(upstream_i), blocks(0) {}
+
+        size_t getBlocks() const { return blocks; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            ++blocks;
+            return upstream->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override{
+            upstream->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+            return this == &other;
+        }
+
+        std::pmr::memory_resource* upstream;
+        size_t blocks;
+    };
+
+    struct Result{
+        double buildMs;
+        double teardownMs;
+        size_t heapBlocks;
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start){
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Add the items of inventory number i
+    void fill(Inventory& inventory, int i, const std::vector<ItemId>& ids){
+        for (int j = 0; j < ITEMS_PER_INVENTORY; ++j)
+            inventory += ids[(i * 7 + j * 13) % ids.size()];
+    }
+
+    // Fill one zone of inventories from resource, then destroy it; release() frees the arena in one step
+    template<typename Release>
+    Result runZone(std::pmr::memory_resource* resource, const CountingResource& counter, const std::vector<ItemId>& ids,
+                   RemovalPolicy policy, Release release){
+        Result result;
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::pmr::vector<Inventory> zone(resource);
+            zone.reserve(INVENTORIES);
+            for (int i = 0; i < INVENTORIES; ++i){
+                zone.emplace_back(ITEMS_PER_INVENTORY, policy);
+                fill(zone.back(), i, ids);
+            }
+            result.buildMs = millisecondsSince(start);
+            start = std::chrono::steady_clock::now();
+        }
+        release();
+        result.teardownMs = millisecondsSince(start);
+        result.heapBlocks = counter.getBlocks();
+        return result;
+    }
+
+    // Same zone in a monotonic arena, torn down by release() alone with no destructor run.
+    // Safe only because every byte the inventories own came from the arena and they hold
+    // nothing else (item names stay in the registry).
+    Result runArenaZoneWithoutDestructors(const std::vector<ItemId>& ids, RemovalPolicy policy){
+        CountingResource upstream(std::pmr::new_delete_resource());
+        std::pmr::monotonic_buffer_resource arena(&upstream);
+        std::pmr::polymorphic_allocator<Inventory> alloc(&arena);
+        Result result;
+        auto start = std::chrono::steady_clock::now();
+        Inventory* zone = alloc.allocate(INVENTORIES);
+        for (int i = 0; i < INVENTORIES; ++i){
+            alloc.construct(zone + i, ITEMS_PER_INVENTORY, policy); // Passes the arena on to the inventory
+            fill(zone[i], i, ids);
+        }
+        result.buildMs = millisecondsSince(start);
+        start = std::chrono::steady_clock::now();
+        arena.release();
+        result.teardownMs = millisecondsSince(start);
+        result.heapBlocks = upstream.getBlocks();
+        return result;
+    }
+
+    // Same zone with the lesson class, which is not allocator-aware and stores strings
+    Result runBaselineZone(const std::vector<std::string>& names){
+        Result result;
+        size_t allocationsBefore = allocationCount;
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::optional<lesson0708::Inventory>> zone(INVENTORIES); // The class cannot be moved
+            for (int i = 0; i < INVENTORIES; ++i){
+                lesson0708::Inventory& inventory = zone[i].emplace(ITEMS_PER_INVENTORY);
+                for (int j = 0; j < ITEMS_PER_INVENTORY; ++j)
+                    inventory += names[(i * 7 + j * 13) % names.size()];
+            }
+            result.buildMs = millisecondsSince(start);
+            result.heapBlocks = allocationCount - allocationsBefore;
+            start = std::chrono::steady_clock::now();
+        }
+        result.teardownMs = millisecondsSince(start);
+        return result;
+    }
+
+    void print(const char* name, const Result& result){
+        std::cout << std::setw(22) << name
+                  << std::setw(12) << std::fixed << std::setprecision(1) << result.buildMs
+                  << std::setw(14) << result.teardownMs
+                  << std::setw(14) << result.heapBlocks << "\n";
+    }
+}
+
+int main(){
+    std::vector<std::string> names;
+    std::vector<ItemId> ids;
+    for (int i = 0; i < ITEM_KINDS; ++i){
+        names.push_back("Item " + std::to_string(i));
+        ids.push_back(ItemRegistry::global().intern(names.back()));
+    }
+
+    std::cout << INVENTORIES << " inventories x " << ITEMS_PER_INVENTORY << " items\n";
+    std::cout << std::setw(22) << "resource" << std::setw(12) << "build ms" << std::setw(14) << "teardown ms" << std::setw(14) << "heap blocks" << "\n";
+
+    print("07_08e orig", runBaselineZone(names));
+    for (RemovalPolicy policy : {RemovalPolicy::LINEAR, RemovalPolicy::SWAP_AND_POP}){
+        std::cout << (policy == RemovalPolicy::LINEAR ? "LINEAR, no index\n" : "SWAP_AND_POP, hash index\n");
+        {
+            CountingResource heap(std::pmr::new_delete_resource());
+            print("new/delete", runZone(&heap, heap, ids, policy, []{}));
+        }
+        {
+            CountingResource upstream(std::pmr::new_delete_resource());
+            std::pmr::unsynchronized_pool_resource pool(&upstream);
+            print("pool", runZone(&pool, upstream, ids, policy, [&pool]{ pool.release(); }));
+        }
+        {
+            CountingResource upstream(std::pmr::new_delete_resource());
+            std::pmr::monotonic_buffer_resource arena(&upstream);
+            print("monotonic", runZone(&arena, upstream, ids, policy, [&arena]{ arena.release(); }));
+        }
+        print("monotonic, no dtors", runArenaZoneWithoutDestructors(ids, policy));
+    }
+    return 0;
+}
@@ -0,0 +1,247 @@
+// Inventory benchmark suite
+// Runs add/index/remove/display workloads from 10 to 1M items against every
+// registered Inventory implementation and reports ns/op, allocations/op and how much
+// the resident set grew. Each implementation and size runs in its own child process,
+// so one run's memory peak never shows up in the next.
+//
+// The chapter 7 lesson classes come from lesson_inventories.h, copies of the classes
+// the lessons show; "07_08e orig" is the lesson class as first written and "07_08e mod"
+// the same class with the later changes (linear removal, the lesson's default).
+//
+// To add an implementation, give it an adapter (see OperatorAdapter and
+// MethodAdapter) and append it to candidates() below.
+//
+// Usage: inventory_suite [max items]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <streambuf>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "inventory.h"
+#include "inline_inventory.h"
+#include "lesson_inventories.h"
+
+// Count every heap allocation made through operator new
+namespace {
+    size_t allocationCount = 0;
+}
+
+void* operator new(size_t size){
+    ++allocationCount;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept{
+    std::free(p);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned forms
+void* operator new(size_t size, std::align_val_t alignment){
+    ++allocationCount;
+    size_t align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept{
+    std::free(p);
+}
+
+namespace {
+    // Common interface every implementation is driven through
+    class Harness{
+    public:
+        virtual ~Harness() = default;
+        virtual void add(const std::string& item) = 0;
+        virtual void remove(const std::string& item) = 0;
+        virtual size_t read(int index) = 0; // Returns something derived from the item so reads are not optimized away
+        virtual void display() = 0;
+    };
+
+    // Adapter for classes with the += / -= / [] operator surface (07_08e and later)
+    template<typename Impl>
+    class OperatorAdapter : public Harness{
+    public:
+        template<typename... Args>
+        explicit OperatorAdapter(Args&&... args): inventory(std::forward<Args>(args)...) {}
+
+        void add(const std::string& item) override { inventory += item; }
+        void remove(const std::string& item) override { inventory -= item; }
+        size_t read(int index) override { return inventory[index].size(); }
+        void display() override { inventory.displayInventory(); }
+
+    private:
+        Impl inventory;
+    };
+
+    // Adapter for classes with the addItem / removeItem / getItem surface (07_05e, 07_07b)
+    template<typename Impl>
+    class MethodAdapter : public Harness{
+    public:
+        explicit MethodAdapter(int capacity): inventory(capacity) {}
+
+        void add(const std::string& item) override { inventory.addItem(item); }
+        void remove(const std::string& item) override { inventory.removeItem(item); }
+        size_t read(int index) override { return inventory.getItem(index).size(); }
+        void display() override { inventory.displayInventory(); }
+
+    private:
+        Impl inventory;
+    };
+
+    struct Candidate{
+        const char* name;
+        std::function<std::unique_ptr<Harness>(int capacity)> make;
+    };
+
+    // Every implementation the suite measures
+    std::vector<Candidate> candidates(){
+        return {
+            {"07_05e", [](int capacity){ return std::make_unique<MethodAdapter<lesson0705::Inventory>>(capacity); }},
+            {"07_07b", [](int capacity){ return std::make_unique<MethodAdapter<lesson0707::Inventory>>(capacity); }},
+            {"07_08e orig", [](int capacity){ return std::make_unique<OperatorAdapter<lesson0708::Inventory>>(capacity); }},
+            {"07_08e mod", [](int capacity){ return std::make_unique<OperatorAdapter<Inventory>>(capacity); }},
+            {"swap-pop", [](int capacity){ return std::make_unique<OperatorAdapter<Inventory>>(capacity, RemovalPolicy::SWAP_AND_POP); }},
+            {"tombstone", [](int capacity){ return std::make_unique<OperatorAdapter<Inventory>>(capacity, RemovalPolicy::TOMBSTONE); }},
+            {"inline<16>", [](int capacity){ return std::make_unique<OperatorAdapter<InlineInventory<16>>>(capacity); }},
+        };
+    }
+
+    // Stream buffer that discards output, so display cost is formatting, not the terminal
+    class NullBuffer : public std::streambuf{
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    const int MAX_REMOVALS = 1000; // Linear removal is O(n), so large sizes remove a sample
+
+    // Current resident set size of the process in megabytes
+    double currentRssMb(){
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        statm >> pages >> resident;
+        return resident * (sysconf(_SC_PAGESIZE) / 1024.0) / 1024.0;
+    }
+
+    // Peak resident set size of the process in megabytes
+    double peakRssMb(){
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss / 1024.0; // Linux reports kilobytes
+    }
+
+    double rssAtStart = 0; // Resident set of the child process before its run
+
+    // Time one workload, returns ns/op and allocations/op
+    struct Measurement{
+        double nsPerOp;
+        double allocsPerOp;
+    };
+
+    template<typename Work>
+    Measurement measure(size_t ops, Work work){
+        size_t allocationsBefore = allocationCount;
+        auto start = std::chrono::steady_clock::now();
+        work();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return Measurement{ns / ops, double(allocationCount - allocationsBefore) / ops};
+    }
+
+    void printRow(const char* name, size_t size, const char* workload, const Measurement& m){
+        std::cout << std::setw(12) << name << std::setw(10) << size << std::setw(10) << workload
+                  << std::setw(12) << std::fixed << std::setprecision(1) << m.nsPerOp
+                  << std::setw(12) << std::setprecision(2) << m.allocsPerOp
+                  << std::setw(12) << std::setprecision(1) << peakRssMb() - rssAtStart << "\n";
+    }
+
+    // All four workloads on one implementation and size; runs in a child process
+    void runCandidate(const Candidate& candidate, size_t size, const std::vector<std::string>& names){
+        rssAtStart = currentRssMb();
+        NullBuffer nullBuffer;
+        std::mt19937 rng(42);
+        auto inventory = candidate.make(static_cast<int>(size));
+
+        printRow(candidate.name, size, "add", measure(size, [&]{
+            for (size_t i = 0; i < size; ++i) inventory->add(names[i]);
+        }));
+
+        std::vector<int> indices(size);
+        for (size_t i = 0; i < size; ++i) indices[i] = rng() % size;
+        size_t checksum = 0;
+        printRow(candidate.name, size, "index", measure(size, [&]{
+            for (int index : indices) checksum += inventory->read(index);
+        }));
+        if (checksum == 0) std::cout << ""; // Keep the reads observable
+
+        std::streambuf* original = std::cout.rdbuf(&nullBuffer);
+        Measurement display = measure(size, [&]{ inventory->display(); });
+        std::cout.rdbuf(original);
+        printRow(candidate.name, size, "display", display);
+
+        std::vector<size_t> victims(size);
+        for (size_t i = 0; i < size; ++i) victims[i] = i;
+        std::shuffle(victims.begin(), victims.end(), rng);
+        victims.resize(std::min<size_t>(size, MAX_REMOVALS));
+        printRow(candidate.name, size, "remove", measure(victims.size(), [&]{
+            for (size_t victim : victims) inventory->remove(names[victim]);
+        }));
+    }
+}
+
+int main(int argc, char* argv[]){
+    size_t maxItems = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::vector<std::string> names;
+    names.reserve(maxItems);
+    for (size_t i = 0; i < maxItems; ++i)
+        names.push_back("Item " + std::to_string(i));
+
+    std::cout << std::setw(12) << "impl" << std::setw(10) << "items" << std::setw(10) << "workload"
+              << std::setw(12) << "ns/op" << std::setw(12) << "allocs/op" << std::setw(12) << "RSS +MB" << "\n";
+
+    for (const Candidate& candidate : candidates()){
+        for (size_t size = 10; size <= maxItems; size *= 10){
+            std::cout.flush(); // The child inherits anything still buffered
+            pid_t child = fork();
+            if (child < 0){
+                std::cerr << "fork failed" << std::endl;
+                return 1;
+            }
+            if (child == 0){
+                runCandidate(candidate, size, names);
+                std::cout.flush();
+                _exit(0);
+            }
+            int status = 0;
+            waitpid(child, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                std::cout << std::setw(12) << candidate.name << std::setw(10) << size << "  run failed\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#ifndef LESSON_INVENTORIES_H
+#define LESSON_INVENTORIES_H
+
+// Copies of the chapter 7 lesson Inventory classes (07_05e, 07_07b and 07_08e before
+// any optimization), so the benchmarks can measure them next to the current one.
+// Each lives in its own namespace and is kept as the lesson wrote it, except that
+// only the constructors the benchmarks call are copied, the signed/unsigned
+// comparisons are made explicit and copying (a double delete in the lessons) is
+// disabled.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// Inventory as lesson 07_05e wrote it, with addItem/removeItem/getItem methods
+namespace lesson0705 {
+    class Inventory{
+    public:
+        // Overloaded Constructor
+        Inventory(int capacity_i): capacity(capacity_i){
+            items = new std::vector<std::string>();
+        }
+
+        // Owns a raw pointer, so copies are not allowed
+        Inventory(const Inventory&) = delete;
+        Inventory& operator=(const Inventory&) = delete;
+
+        // Destructor
+        ~Inventory(){
+            delete items; // Prevent memory leak by deallocating the dynamic vector
+        }
+
+        // Add item to inventory
+        void addItem(const std::string& item){
+            if (items->size() < static_cast<size_t>(capacity))
+                items->push_back(item);
+            else
+                std::cout << "Inventory is full, cannot add " << item << std::endl;
+        }
+
+        // Remove item from inventory
+        void removeItem(const std::string& item){
+            auto it = std::find(items->begin(), items->end(), item);
+            if (it != items->end())
+                items->erase(it);
+            else
+                std::cout << "Item " << item << " not found in inventory" << std::endl;
+        }
+
+        // Access item by index
+        std::string getItem(int index) const{
+            if (index >= 0 && static_cast<size_t>(index) < items->size())
+                return (*items)[index];
+            else
+                return "Index out of bounds";
+        }
+
+        // Get number of items in the inventory
+        int getItemCount() const{
+            return items->size();
+        }
+
+        // Display inventory contents
+        void displayInventory() const{
+            std::cout << "Inventory: [ ";
+            for (size_t i = 0; i < items->size(); ++i){
+                std::cout << (*items)[i];
+                if (i < items->size() - 1) std::cout << ", ";
+            }
+            std::cout << " ]" << std::endl;
+        }
+
+    private:
+        std::vector<std::string> *items; // Pointer to a vector of items
+        int capacity; // Maximum number of items allowed
+    };
+}
+
+// Inventory as lesson 07_07b wrote it, identical to 07_05e except for the default
+// constructor, which is not copied
+namespace lesson0707 {
+    class Inventory{
+    public:
+        // Overloaded Constructor
+        Inventory(int capacity_i): capacity(capacity_i){
+            items = new std::vector<std::string>();
+        }
+
+        // Owns a raw pointer, so copies are not allowed
+        Inventory(const Inventory&) = delete;
+        Inventory& operator=(const Inventory&) = delete;
+
+        // Destructor
+        ~Inventory(){
+            delete items; // Prevent memory leak by deallocating the dynamic vector
+        }
+
+        // Add item to inventory
+        void addItem(const std::string& item){
+            if (items->size() < static_cast<size_t>(capacity))
+                items->push_back(item);
+            else
+                std::cout << "Inventory is full, cannot add " << item << std::endl;
+        }
+
+        // Remove item from inventory
+        void removeItem(const std::string& item){
+            auto it = std::find(items->begin(), items->end(), item);
+            if (it != items->end())
+                items->erase(it);
+            else
+                std::cout << "Item " << item << " not found in inventory" << std::endl;
+        }
+
+        // Access item by index
+        std::string getItem(int index) const{
+            if (index >= 0 && static_cast<size_t>(index) < items->size())
+                return (*items)[index];
+            else
+                return "Index out of bounds";
+        }
+
+        // Get number of items in the inventory
+        int getItemCount() const{
+            return items->size();
+        }
+
+        // Display inventory contents
+        void displayInventory() const{
+            std::cout << "Inventory: [ ";
+            for (size_t i = 0; i < items->size(); ++i){
+                std::cout << (*items)[i];
+                if (i < items->size() - 1) std::cout << ", ";
+            }
+            std::cout << " ]" << std::endl;
+        }
+
+    private:
+        std::vector<std::string> *items; // Pointer to a vector of items
+        int capacity; // Maximum number of items allowed
+    };
+}
+
+// Inventory as lesson 07_08e first wrote it, before any of the later optimizations
+namespace lesson0708 {
+    class Inventory{
+    public:
+        // Overloaded Constructor
+        Inventory(int capacity_i): capacity(capacity_i){
+            items = new std::vector<std::string>();
+        }
+
+        // Owns a raw pointer, so copies are not allowed
+        Inventory(const Inventory&) = delete;
+        Inventory& operator=(const Inventory&) = delete;
+
+        // Destructor
+        ~Inventory(){
+            delete items; // Prevent memory leak by deallocating the dynamic vector
+        }
+
+        // Overload += operator to add an item
+        Inventory& operator+=(const std::string& item){
+            if (items->size() < static_cast<size_t>(capacity))
+                items->push_back(item);
+            else
+                std::cout << "Inventory is full, cannot add " << item << std::endl;
+            return *this;
+        }
+
+        // Overload -= operator to remove an item
+        Inventory& operator-=(const std::string& item){
+            auto it = std::find(items->begin(), items->end(), item);
+            if (it != items->end())
+                items->erase(it);
+            else
+                std::cout << "Item " << item << " not found in inventory" << std::endl;
+            return *this;
+        }
+
+        // Overload [] operator to access item by index
+        std::string operator[](int index) const{
+            if (index >= 0 && static_cast<size_t>(index) < items->size())
+                return (*items)[index];
+            else
+                return "Index out of bounds";
+        }
+
+        // Get number of items in the inventory
+        int getItemCount() const{
+            return items->size();
+        }
+
+        // Display inventory contents
+        void displayInventory() const{
+            std::cout << "Inventory: [ ";
+            for (size_t i = 0; i < items->size(); ++i){
+                std::cout << (*items)[i];
+                if (i < items->size() - 1) std::cout << ", ";
+            }
+            std::cout << " ]" << std::endl;
+        }
+
+    private:
+        std::vector<std::string> *items; // Pointer to a vector of items
+        int capacity; // Maximum number of items allowed
+    };
+}
+
+#endif // LESSON_INVENTORIES_H
@@ -0,0 +1,254 @@
+#include "concurrent_inventory.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace {
+    using Entry = ConcurrentInventory::Entry;
+
+    // Position of item in a sorted entry list, or where it would go
+    std::vector<Entry>::const_iterator findEntry(const std::vector<Entry>& entries, ItemId item){
+        return std::lower_bound(entries.begin(), entries.end(), item,
+            [](const Entry& entry, ItemId id){ return entry.item.value < id.value; });
+    }
+
+    // Units of item held in one version of a shard
+    int quantityIn(const ConcurrentInventory::ShardData& data, ItemId item){
+        auto change = findEntry(data.changes, item);
+        if (change != data.changes.end() && change->item == item)
+            return change->quantity;
+        auto it = findEntry(*data.base, item);
+        return it != data.base->end() && it->item == item ? it->quantity : 0;
+    }
+}
+
+// Default Constructor
+ConcurrentInventory::ConcurrentInventory(): ConcurrentInventory(10, 16, ItemRegistry::global()) {}
+
+// Overloaded Constructor
+ConcurrentInventory::ConcurrentInventory(int capacity_i): ConcurrentInventory(capacity_i, 16, ItemRegistry::global()) {}
+
+// Overloaded Constructor with a shard count
+ConcurrentInventory::ConcurrentInventory(int capacity_i, size_t shardCount_i): ConcurrentInventory(capacity_i, shardCount_i, ItemRegistry::global()) {}
+
+// Overloaded Constructor with a shard count and a per-world registry
+ConcurrentInventory::ConcurrentInventory(int capacity_i, size_t shardCount_i, ItemRegistry& registry_i)
+    : shards(new Shard[std::max<size_t>(shardCount_i, 1)]), shardCount(std::max<size_t>(shardCount_i, 1)),
+      epoch(1), readers(new ReaderSlot[READER_SLOTS]), units(0), capacity(capacity_i), registry(&registry_i){
+    auto empty = std::make_shared<const std::vector<Entry>>();
+    for (size_t i = 0; i < shardCount; ++i){
+        auto first = std::make_unique<ShardData>();
+        first->base = empty;
+        shards[i].data.store(first.release());
+    }
+}
+
+// Destructor
+ConcurrentInventory::~ConcurrentInventory(){
+    for (size_t i = 0; i < shardCount; ++i){
+        delete shards[i].data.load();
+        for (const Retired& retired : shards[i].retired)
+            delete retired.data;
+    }
+}
+
+// Overload += operator to add an item
+ConcurrentInventory& ConcurrentInventory::operator+=(const std::string& item){
+    if (!tryAdd(registry->intern(item)))
+        std::cout << "Inventory is full, cannot add " << item << std::endl;
+    return *this;
+}
+
+ConcurrentInventory& ConcurrentInventory::operator+=(ItemId item){
+    if (!tryAdd(item))
+        std::cout << "Inventory is full, cannot add " << registry->name(item) << std::endl;
+    return *this;
+}
+
+// Overload -= operator to remove an item
+ConcurrentInventory& ConcurrentInventory::operator-=(const std::string& item){
+    std::optional<ItemId> id = registry->lookup(item);
+    if (!id || !tryRemove(*id))
+        std::cout << "Item " << item << " not found in inventory" << std::endl;
+    return *this;
+}
+
+ConcurrentInventory& ConcurrentInventory::operator-=(ItemId item){
+    if (!tryRemove(item))
+        std::cout << "Item " << registry->name(item) << " not found in inventory" << std::endl;
+    return *this;
+}
+
+// Add one unit without printing, returns false when full
+bool ConcurrentInventory::tryAdd(ItemId item){
+    // Reserve a unit first so concurrent adds can never overshoot capacity
+    if (units.fetch_add(1, std::memory_order_relaxed) >= capacity){
+        units.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Shard& shard = shards[shardOf(item)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    try{
+        update(shard, item, 1);
+    }
+    catch (...){
+        units.fetch_sub(1, std::memory_order_relaxed);
+        throw;
+    }
+    return true;
+}
+
+// Remove one unit without printing, returns false when not found
+bool ConcurrentInventory::tryRemove(ItemId item){
+    Shard& shard = shards[shardOf(item)];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!update(shard, item, -1))
+            return false;
+    }
+    units.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Take a consistent view without locking
+ConcurrentInventory::Snapshot ConcurrentInventory::snapshot() const{
+    // Threads start at different slots so they rarely compete for one
+    size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % READER_SLOTS;
+    for (;;){
+        for (size_t i = 0; i < READER_SLOTS; ++i){
+            size_t slot = (start + i) % READER_SLOTS;
+            std::uint64_t free = 0;
+            // Announce the epoch before loading any shard, so no writer frees what this view loads
+            if (readers[slot].epoch.compare_exchange_strong(free, epoch.load()))
+                return Snapshot(this, slot);
+        }
+        std::this_thread::yield(); // Every slot holds an open snapshot
+    }
+}
+
+// Get number of units in the inventory
+int ConcurrentInventory::getItemCount() const{
+    return units.load(std::memory_order_relaxed);
+}
+
+// Display inventory contents from a snapshot
+void ConcurrentInventory::displayInventory() const{
+    snapshot().displayInventory();
+}
+
+// Shard that owns an item
+size_t ConcurrentInventory::shardOf(ItemId item) const{
+    return std::hash<ItemId>()(item) % shardCount;
+}
+
+// Change one item's quantity by delta in a shard (caller holds its lock), false if it is not held
+bool ConcurrentInventory::update(Shard& shard, ItemId item, int delta){
+    const ShardData* current = shard.data.load(std::memory_order_relaxed); // Only stored under this lock
+    int quantity = quantityIn(*current, item) + delta;
+    if (quantity < 0)
+        return false;
+
+    auto next = std::make_unique<ShardData>();
+    next->units = current->units + delta;
+    next->changes.reserve(current->changes.size() + 1);
+    next->changes = current->changes;
+    auto it = next->changes.begin() + (findEntry(current->changes, item) - current->changes.begin());
+    if (it != next->changes.end() && it->item == item)
+        it->quantity = quantity;
+    else
+        next->changes.insert(it, Entry{item, quantity});
+
+    if (next->changes.size() <= MAX_CHANGES){
+        next->base = current->base;
+    } else {
+        // Fold the changes into a new base, dropping items no longer held
+        const std::vector<Entry>& base = *current->base;
+        auto merged = std::make_shared<std::vector<Entry>>();
+        merged->reserve(base.size() + next->changes.size());
+        size_t b = 0;
+        for (const Entry& change : next->changes){
+            for (; b < base.size() && base[b].item.value < change.item.value; ++b)
+                merged->push_back(base[b]);
+            if (b < base.size() && base[b].item == change.item)
+                ++b;
+            if (change.quantity > 0)
+                merged->push_back(change);
+        }
+        merged->insert(merged->end(), base.begin() + b, base.end());
+        next->base = std::move(merged);
+        next->changes.clear();
+    }
+
+    shard.retired.reserve(shard.retired.size() + 1);
+    shard.data.store(next.release());
+    // Read after publishing: a snapshot announcing a later epoch can only see the new version
+    shard.retired.push_back(Retired{current, epoch.load()});
+    if (shard.retired.size() >= MAX_CHANGES)
+        reclaim(shard);
+    return true;
+}
+
+// Free retired versions no open snapshot can see (caller holds the shard lock)
+void ConcurrentInventory::reclaim(Shard& shard){
+    // Snapshots announcing an epoch after every retirement so far cannot hold a retired version
+    std::uint64_t oldest = epoch.fetch_add(1) + 1;
+    for (size_t i = 0; i < READER_SLOTS; ++i){
+        std::uint64_t announced = readers[i].epoch.load();
+        if (announced != 0 && announced < oldest)
+            oldest = announced;
+    }
+    auto kept = std::remove_if(shard.retired.begin(), shard.retired.end(), [oldest](const Retired& retired){
+        if (retired.epoch >= oldest)
+            return false;
+        delete retired.data;
+        return true;
+    });
+    shard.retired.erase(kept, shard.retired.end());
+}
+
+// Load every shard's version (the slot already announces this snapshot's epoch)
+ConcurrentInventory::Snapshot::Snapshot(const ConcurrentInventory* owner_i, size_t slot_i)
+    : owner(owner_i), slot(slot_i), shards(owner_i->shardCount){
+    for (size_t i = 0; i < shards.size(); ++i)
+        shards[i] = owner->shards[i].data.load();
+}
+
+ConcurrentInventory::Snapshot::Snapshot(Snapshot&& other) noexcept
+    : owner(other.owner), slot(other.slot), shards(std::move(other.shards)){
+    other.owner = nullptr;
+}
+
+// Destructor
+ConcurrentInventory::Snapshot::~Snapshot(){
+    if (owner)
+        owner->readers[slot].epoch.store(0, std::memory_order_release);
+}
+
+// Get number of units in the snapshot
+int ConcurrentInventory::Snapshot::getItemCount() const{
+    int count = 0;
+    for (const ShardData* shard : shards)
+        count += shard->units;
+    return count;
+}
+
+// Get units held of one item
+int ConcurrentInventory::Snapshot::getQuantity(ItemId item) const{
+    return quantityIn(*shards[std::hash<ItemId>()(item) % shards.size()], item);
+}
+
+// Display snapshot contents
+void ConcurrentInventory::Snapshot::displayInventory() const{
+    std::vector<Entry> all;
+    forEach([&all](ItemId item, int quantity){ all.push_back(Entry{item, quantity}); });
+    std::sort(all.begin(), all.end(), [](const Entry& a, const Entry& b){ return a.item.value < b.item.value; });
+
+    std::cout << "Inventory: [ ";
+    for (size_t i = 0; i < all.size(); ++i){
+        std::cout << owner->registry->name(all[i].item);
+        if (all[i].quantity > 1) std::cout << " x" << all[i].quantity;
+        if (i < all.size() - 1) std::cout << ", ";
+    }
+    std::cout << " ]" << std::endl;
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#ifndef CONCURRENT_INVENTORY_H
+#define CONCURRENT_INVENTORY_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include "item_registry.h"
+
+// Inventory shared by several threads.
+// Each shard publishes its own immutable version through one atomic pointer. A writer locks only
+// the shard that owns the item, builds the next version and swaps the pointer, so writers to
+// different shards share no lock. A version is a sorted base, shared with the versions before it,
+// plus a small sorted list of changes on top; a write copies the changes, and only when they pass
+// MAX_CHANGES does it merge them into a new base, so a write costs O(MAX_CHANGES) amortized rather
+// than a copy of the shard.
+// Readers take a snapshot: they announce the epoch they started in (epoch-based reclamation) and
+// load each shard's pointer once, never taking a lock or waiting for a writer. Replaced versions
+// are freed only once no reader announced an epoch old enough to still see them.
+// A snapshot is consistent per shard: every item's quantity is one its shard really held, and the
+// shards are read one after another, not all at the same instant.
+class ConcurrentInventory{
+public:
+    // One item and how many units of it a shard holds
+    struct Entry{
+        ItemId item;
+        int quantity;
+    };
+
+    // Immutable contents of one shard
+    struct ShardData{
+        std::shared_ptr<const std::vector<Entry>> base; // Sorted by item id, shared between versions
+        std::vector<Entry> changes; // Sorted by item id, replaces base quantities (0 = removed)
+        int units = 0; // Sum of quantities
+    };
+
+    // Consistent read-only view of the whole inventory, valid while the inventory lives.
+    // Holding one keeps the shard versions it sees alive, so drop it when done.
+    class Snapshot{
+    public:
+        Snapshot(Snapshot&& other) noexcept;
+        Snapshot& operator=(Snapshot&&) = delete;
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        // Destructor
+        ~Snapshot();
+
+        // Get number of units in the snapshot
+        int getItemCount() const;
+
+        // Get units held of one item
+        int getQuantity(ItemId item) const;
+
+        // Call visit(ItemId, quantity) for every item held, in id order within each shard
+        template<typename Visitor>
+        void forEach(Visitor visit) const{
+            for (const ShardData* shard : shards){
+                const std::vector<Entry>& base = *shard->base;
+                size_t b = 0;
+                for (const Entry& change : shard->changes){
+                    for (; b < base.size() && base[b].item.value < change.item.value; ++b)
+                        visit(base[b].item, base[b].quantity);
+                    if (b < base.size() && base[b].item == change.item)
+                        ++b;
+                    if (change.quantity > 0)
+                        visit(change.item, change.quantity);
+                }
+                for (; b < base.size(); ++b)
+                    visit(base[b].item, base[b].quantity);
+            }
+        }
+
+        // Display snapshot contents
+        void displayInventory() const;
+
+    private:
+        friend class ConcurrentInventory;
+        Snapshot(const ConcurrentInventory* owner_i, size_t slot_i);
+
+        const ConcurrentInventory* owner; // Null once moved from
+        size_t slot; // Reader slot announcing this snapshot's epoch
+        std::vector<const ShardData*> shards; // One version per shard
+    };
+
+    // Constructor
+    ConcurrentInventory();
+
+    // Overloaded Constructor
+    ConcurrentInventory(int capacity_i);
+
+    // Overloaded Constructor with a shard count
+    ConcurrentInventory(int capacity_i, size_t shardCount_i);
+
+    // Overloaded Constructor with a shard count and a per-world registry
+    ConcurrentInventory(int capacity_i, size_t shardCount_i, ItemRegistry& registry_i);
+
+    // Shards hold mutexes, so the inventory stays where it was built
+    ConcurrentInventory(const ConcurrentInventory&) = delete;
+    ConcurrentInventory& operator=(const ConcurrentInventory&) = delete;
+
+    // Destructor
+    ~ConcurrentInventory();
+
+    // Add item to inventory
+    ConcurrentInventory& operator+=(const std::string& item);
+    ConcurrentInventory& operator+=(ItemId item);
+
+    // Remove item from inventory
+    ConcurrentInventory& operator-=(const std::string& item);
+    ConcurrentInventory& operator-=(ItemId item);
+
+    // Add one unit without printing, returns false when full
+    bool tryAdd(ItemId item);
+
+    // Remove one unit without printing, returns false when not found
+    bool tryRemove(ItemId item);
+
+    // Take a consistent view without locking
+    Snapshot snapshot() const;
+
+    // Get number of units in the inventory
+    int getItemCount() const;
+
+    // Display inventory contents from a snapshot
+    void displayInventory() const;
+
+    static constexpr size_t MAX_CHANGES = 32; // Changes a version carries before they are merged into its base
+    static constexpr size_t READER_SLOTS = 64; // Snapshots that can be open at once; more wait for a free slot
+
+private:
+    // A replaced version and the epoch it was replaced in
+    struct Retired{
+        const ShardData* data;
+        std::uint64_t epoch;
+    };
+
+    // Writer lock, published version and versions waiting to be freed of one shard
+    struct alignas(64) Shard{
+        std::mutex mutex;
+        std::atomic<const ShardData*> data{nullptr}; // Published version, replaced under mutex
+        std::vector<Retired> retired; // Only touched under mutex
+    };
+
+    // Epoch a reader announced, 0 while the slot is free; one cache line each
+    struct alignas(64) ReaderSlot{
+        std::atomic<std::uint64_t> epoch{0};
+    };
+
+    // Shard that owns an item
+    size_t shardOf(ItemId item) const;
+
+    // Change one item's quantity by delta in a shard (caller holds its lock), false if it is not held
+    bool update(Shard& shard, ItemId item, int delta);
+
+    // Free retired versions no open snapshot can see (caller holds the shard lock)
+    void reclaim(Shard& shard);
+
+    std::unique_ptr<Shard[]> shards; // Fixed set of shards
+    size_t shardCount; // Number of shards
+    mutable std::atomic<std::uint64_t> epoch; // Advanced by writers freeing versions, read by snapshots
+    mutable std::unique_ptr<ReaderSlot[]> readers; // Epochs announced by open snapshots
+    std::atomic<int> units; // Units held or reserved by writers
+    int capacity; // Maximum number of units allowed
+    ItemRegistry* registry; // Resolves ids to names, never null
+};
+
+#endif // CONCURRENT_INVENTORY_H
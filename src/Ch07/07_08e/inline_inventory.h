@@ -0,0 +1,208 @@
+#pragma once
+
+#ifndef INLINE_INVENTORY_H
+#define INLINE_INVENTORY_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include "item_registry.h"
+#include "inventory_render.h"
+
+// Inventory that keeps up to N items inside the object and only uses the heap past N
+template<size_t N>
+class InlineInventory{
+    static_assert(N > 0, "InlineInventory needs room for at least one inline item");
+
+public:
+    // Forward iterator over item names
+    class const_iterator{
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string*;
+        using reference = const std::string&;
+
+        const_iterator(): id(nullptr), registry(nullptr) {}
+        const_iterator(const ItemId* id_i, const ItemRegistry* registry_i): id(id_i), registry(registry_i) {}
+
+        reference operator*() const { return registry->name(*id); }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++(){ ++id; return *this; }
+        const_iterator operator++(int){ const_iterator old = *this; ++id; return old; }
+
+        bool operator==(const const_iterator& other) const { return id == other.id; }
+        bool operator!=(const const_iterator& other) const { return id != other.id; }
+
+    private:
+        const ItemId* id;
+        const ItemRegistry* registry;
+    };
+
+    // Default Constructor
+    InlineInventory(): local{}, count(0), capacity(10), registry(&ItemRegistry::global()) {}
+
+    // Overloaded Constructor
+    InlineInventory(int capacity_i): local{}, count(0), capacity(capacity_i), registry(&ItemRegistry::global()) {}
+
+    // Overloaded Constructor with a per-world registry
+    InlineInventory(int capacity_i, ItemRegistry& registry_i): local{}, count(0), capacity(capacity_i), registry(&registry_i) {}
+
+    // Copy is member-wise
+    InlineInventory(const InlineInventory& other) = default;
+    InlineInventory& operator=(const InlineInventory& other) = default;
+
+    // Move steals the heap block when spilled, leaves other empty
+    InlineInventory(InlineInventory&& other) noexcept
+        : local(other.local), heap(std::move(other.heap)), count(other.count), capacity(other.capacity), registry(other.registry){
+        other.heap.clear();
+        other.count = 0;
+    }
+
+    InlineInventory& operator=(InlineInventory&& other) noexcept{
+        if (this != &other){
+            local = other.local;
+            heap = std::move(other.heap);
+            count = other.count;
+            capacity = other.capacity;
+            registry = other.registry;
+            other.heap.clear();
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    // Add item to inventory
+    InlineInventory& operator+=(const std::string& item){
+        if (getItemCount() < capacity)
+            append(registry->intern(item));
+        else
+            std::cout << "Inventory is full, cannot add " << item << std::endl;
+        return *this;
+    }
+
+    InlineInventory& operator+=(ItemId item){
+        if (getItemCount() < capacity)
+            append(item);
+        else
+            std::cout << "Inventory is full, cannot add " << registry->name(item) << std::endl;
+        return *this;
+    }
+
+    // Remove item from inventory
+    InlineInventory& operator-=(const std::string& item){
+        std::optional<ItemId> id = registry->lookup(item);
+        if (!id || !remove(*id))
+            std::cout << "Item " << item << " not found in inventory" << std::endl;
+        return *this;
+    }
+
+    InlineInventory& operator-=(ItemId item){
+        if (!remove(item))
+            std::cout << "Item " << registry->name(item) << " not found in inventory" << std::endl;
+        return *this;
+    }
+
+    // Access item by index, returns "Index out of bounds" on a miss
+    const std::string& operator[](int index) const{
+        static const std::string outOfBounds = "Index out of bounds";
+        if (index >= 0 && static_cast<size_t>(index) < count)
+            return registry->name(data()[index]);
+        else
+            return outOfBounds;
+    }
+
+    // Access item by index without bounds reporting (index must be valid)
+    std::string_view itemAt(int index) const{
+        return registry->name(data()[index]);
+    }
+
+    // Access item by index, nullopt when out of bounds
+    std::optional<std::string_view> tryGetItem(int index) const{
+        if (index >= 0 && static_cast<size_t>(index) < count)
+            return std::string_view(registry->name(data()[index]));
+        return std::nullopt;
+    }
+
+    // Get number of items in the inventory
+    int getItemCount() const{
+        return static_cast<int>(count);
+    }
+
+    // True while the items still fit in the inline buffer
+    bool isInline() const{
+        return heap.empty();
+    }
+
+    // Display inventory contents
+    void displayInventory() const{
+        thread_local RenderBuffer buffer;
+        renderInventory(*this, buffer, RenderFormat::TEXT);
+        buffer.flushTo(std::cout);
+    }
+
+    // Render inventory contents into a caller-owned buffer, no output is written
+    void render(RenderBuffer& out, RenderFormat format, std::string_view label = "Inventory") const{
+        renderInventory(*this, out, format, label);
+    }
+
+    // Iterate over item names in order
+    const_iterator begin() const { return const_iterator(data(), registry); }
+    const_iterator end() const { return const_iterator(data() + count, registry); }
+
+private:
+    // Items live in local until they spill, then all of them live in heap
+    const ItemId* data() const { return heap.empty() ? local.data() : heap.data(); }
+    ItemId* data() { return heap.empty() ? local.data() : heap.data(); }
+
+    // Append an id that is known to fit
+    void append(ItemId item){
+        if (heap.empty() && count < N){
+            local[count++] = item;
+            return;
+        }
+        if (heap.empty()){
+            heap.reserve(2 * N);
+            heap.assign(local.begin(), local.begin() + count);
+        }
+        heap.push_back(item);
+        ++count;
+    }
+
+    // Remove the first copy of an id, keeps order, returns false if not found
+    bool remove(ItemId item){
+        ItemId* first = data();
+        ItemId* it = std::find(first, first + count, item);
+        if (it == first + count) return false;
+
+        if (heap.empty()){
+            std::copy(it + 1, first + count, it);
+            --count;
+            return true;
+        }
+        heap.erase(heap.begin() + (it - first));
+        --count;
+        if (count <= N / 2){
+            // Move back inline once comfortably below N, so the boundary does not thrash
+            std::copy(heap.begin(), heap.end(), local.begin());
+            std::vector<ItemId>().swap(heap);
+        }
+        return true;
+    }
+
+    std::array<ItemId, N> local; // Inline storage for the first N items
+    std::vector<ItemId> heap; // Every item once more than N are held
+    size_t count; // Number of items
+    int capacity; // Maximum number of items allowed
+    ItemRegistry* registry; // Resolves ids to names, never null
+};
+
+#endif // INLINE_INVENTORY_H
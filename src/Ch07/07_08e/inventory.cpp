@@ -1,58 +1,658 @@
 #include "inventory.h"
+#include <utility>
+#include <stdexcept>
 
-// Default Constructor
-Inventory::Inventory(): capacity(10){
-    items = new std::vector<std::string>();
+namespace {
+    // Make room for extra more elements, doubling so repeated single-element calls stay amortized O(1)
+    template<typename Vector>
+    void growFor(Vector& vector, size_t extra){
+        if (vector.size() + extra > vector.capacity())
+            vector.reserve(std::max(vector.size() + extra, 2 * vector.capacity()));
+    }
 }
 
+// Default Constructor
+Inventory::Inventory(): Inventory(10, RemovalPolicy::LINEAR, ItemRegistry::global(), allocator_type()) {}
+
 // Overloaded Constructor
-Inventory::Inventory(int capacity_i): capacity(capacity_i){
-    items = new std::vector<std::string>();
+Inventory::Inventory(int capacity_i): Inventory(capacity_i, RemovalPolicy::LINEAR, ItemRegistry::global(), allocator_type()) {}
+
+// Overloaded Constructor with a removal policy
+Inventory::Inventory(int capacity_i, RemovalPolicy policy_i): Inventory(capacity_i, policy_i, ItemRegistry::global(), allocator_type()) {}
+
+// Overloaded Constructor with a removal policy and a per-world registry
+Inventory::Inventory(int capacity_i, RemovalPolicy policy_i, ItemRegistry& registry_i): Inventory(capacity_i, policy_i, registry_i, allocator_type()) {}
+
+// Allocator-extended Constructors
+Inventory::Inventory(const allocator_type& alloc): Inventory(10, RemovalPolicy::LINEAR, ItemRegistry::global(), alloc) {}
+
+Inventory::Inventory(int capacity_i, const allocator_type& alloc): Inventory(capacity_i, RemovalPolicy::LINEAR, ItemRegistry::global(), alloc) {}
+
+Inventory::Inventory(int capacity_i, RemovalPolicy policy_i, const allocator_type& alloc): Inventory(capacity_i, policy_i, ItemRegistry::global(), alloc) {}
+
+Inventory::Inventory(int capacity_i, RemovalPolicy policy_i, ItemRegistry& registry_i, const allocator_type& alloc)
+    : items(alloc), capacity(capacity_i), policy(policy_i), registry(&registry_i),
+      slotIndex(alloc), slotPos(alloc), dead(alloc), tombstones(0), deadTree(alloc),
+      nameIndex(alloc), nameIndexed(false), journal(alloc), journalSequence(0), journaling(false) {}
+
+// Allocator-extended Copy Constructor
+Inventory::Inventory(const Inventory& other, const allocator_type& alloc)
+    : items(other.items, alloc), capacity(other.capacity), policy(other.policy), registry(other.registry),
+      slotIndex(other.slotIndex, alloc), slotPos(other.slotPos, alloc), dead(other.dead, alloc), tombstones(other.tombstones), deadTree(other.deadTree, alloc),
+      nameIndex(other.nameIndex, alloc), nameIndexed(other.nameIndexed),
+      journal(other.journal, alloc), journalSequence(other.journalSequence), journaling(other.journaling) {}
+
+// Move Constructor, leaves other empty
+Inventory::Inventory(Inventory&& other) noexcept
+    : items(std::move(other.items)), capacity(other.capacity), policy(other.policy), registry(other.registry),
+      slotIndex(std::move(other.slotIndex)), slotPos(std::move(other.slotPos)), dead(std::move(other.dead)), tombstones(other.tombstones), deadTree(std::move(other.deadTree)),
+      nameIndex(std::move(other.nameIndex)), nameIndexed(other.nameIndexed),
+      journal(std::move(other.journal)), journalSequence(other.journalSequence), journaling(other.journaling){
+    other.items.clear();
+    other.slotIndex.clear();
+    other.slotPos.clear();
+    other.dead.clear();
+    other.tombstones = 0;
+    other.deadTree.clear();
+    other.nameIndex.clear();
+    other.journal.clear();
 }
 
-// Destructor
-Inventory::~Inventory(){
-    delete items; // Prevent memory leak by deallocating the dynamic vector
+// Allocator-extended Move Constructor, copies if the resources differ
+Inventory::Inventory(Inventory&& other, const allocator_type& alloc)
+    : items(std::move(other.items), alloc), capacity(other.capacity), policy(other.policy), registry(other.registry),
+      slotIndex(std::move(other.slotIndex), alloc), slotPos(std::move(other.slotPos), alloc), dead(std::move(other.dead), alloc), tombstones(other.tombstones), deadTree(std::move(other.deadTree), alloc),
+      nameIndex(std::move(other.nameIndex), alloc), nameIndexed(other.nameIndexed),
+      journal(std::move(other.journal), alloc), journalSequence(other.journalSequence), journaling(other.journaling){
+    other.items.clear();
+    other.slotIndex.clear();
+    other.slotPos.clear();
+    other.dead.clear();
+    other.tombstones = 0;
+    other.deadTree.clear();
+    other.nameIndex.clear();
+    other.journal.clear();
+}
+
+// Move Assignment, leaves other empty
+Inventory& Inventory::operator=(Inventory&& other){
+    if (this != &other){
+        items = std::move(other.items);
+        capacity = other.capacity;
+        policy = other.policy;
+        registry = other.registry;
+        slotIndex = std::move(other.slotIndex);
+        slotPos = std::move(other.slotPos);
+        dead = std::move(other.dead);
+        tombstones = other.tombstones;
+        deadTree = std::move(other.deadTree);
+        nameIndex = std::move(other.nameIndex);
+        nameIndexed = other.nameIndexed;
+        journal = std::move(other.journal);
+        journalSequence = other.journalSequence;
+        journaling = other.journaling;
+        other.items.clear();
+        other.slotIndex.clear();
+        other.slotPos.clear();
+        other.dead.clear();
+        other.tombstones = 0;
+        other.deadTree.clear();
+        other.nameIndex.clear();
+        other.journal.clear();
+    }
+    return *this;
 }
 
 // Overload += operator to add an item
 Inventory& Inventory::operator+=(const std::string& item){
-    if (items->size() < capacity)
-        items->push_back(item);
+    if (getItemCount() < capacity)
+        return *this += registry->intern(item);
+    std::cout << "Inventory is full, cannot add " << item << std::endl;
+    return *this;
+}
+
+Inventory& Inventory::operator+=(ItemId item){
+    if (getItemCount() < capacity)
+        appendId(item);
     else
-        std::cout << "Inventory is full, cannot add " << item << std::endl;
+        std::cout << "Inventory is full, cannot add " << registry->name(item) << std::endl;
     return *this;
 }
 
 // Overload -= operator to remove an item
 Inventory& Inventory::operator-=(const std::string& item){
-    auto it = std::find(items->begin(), items->end(), item);
-    if (it != items->end())
-        items->erase(it);
-    else
-        std::cout << "Item " << item << " not found in inventory" << std::endl;
+    std::optional<ItemId> id = registry->lookup(item); // Never interned means never added
+    if (id)
+        return *this -= *id;
+    std::cout << "Item " << item << " not found in inventory" << std::endl;
+    return *this;
+}
+
+Inventory& Inventory::operator-=(ItemId item){
+    if (removeId(item))
+        return *this;
+    std::cout << "Item " << registry->name(item) << " not found in inventory" << std::endl;
     return *this;
 }
 
 // Overload [] operator to access item by index
-std::string Inventory::operator[](int index) const{
-    if (index >= 0 && index < items->size())
-        return (*items)[index];
+const std::string& Inventory::operator[](int index) const{
+    static const std::string outOfBounds = "Index out of bounds"; // Built once, not per miss
+    long slot = physicalSlot(index);
+    if (slot >= 0)
+        return registry->name(items[slot]);
     else
-        return "Index out of bounds";
+        return outOfBounds;
+}
+
+// Access item by index without bounds reporting (index must be valid)
+std::string_view Inventory::itemAt(int index) const{
+    if (tombstones == 0)
+        return registry->name(items[index]);
+    return registry->name(items[physicalSlot(index)]);
+}
+
+// Access item by index, nullopt when out of bounds
+std::optional<std::string_view> Inventory::tryGetItem(int index) const{
+    long slot = physicalSlot(index);
+    if (slot >= 0)
+        return std::string_view(registry->name(items[slot]));
+    return std::nullopt;
+}
+
+// Access item id by index, nullopt when out of bounds
+std::optional<ItemId> Inventory::getItemId(int index) const{
+    long slot = physicalSlot(index);
+    if (slot >= 0)
+        return items[slot];
+    return std::nullopt;
+}
+
+// Get the registry that resolves this inventory's ids
+ItemRegistry& Inventory::getRegistry() const{
+    return *registry;
 }
 
 // Get number of items in the inventory
 int Inventory::getItemCount() const{
-    return items->size();
+    return items.size() - tombstones;
+}
+
+// Get the allocator the inventory's containers use
+Inventory::allocator_type Inventory::get_allocator() const{
+    return items.get_allocator();
+}
+
+// Get maximum number of items allowed
+int Inventory::getCapacity() const{
+    return capacity;
+}
+
+// Get number of copies of one item, O(1) under the indexed policies
+int Inventory::countOf(ItemId item) const{
+    if (policy == RemovalPolicy::LINEAR)
+        return std::count(items.begin(), items.end(), item);
+    auto it = slotIndex.find(item);
+    return it != slotIndex.end() ? it->second.slots.size() - it->second.head : 0;
 }
 
 // Display inventory contents
 void Inventory::displayInventory() const{
-    std::cout << "Inventory: [ ";
-    for (size_t i = 0; i < items->size(); ++i){
-        std::cout << (*items)[i];
-        if (i < items->size() - 1) std::cout << ", ";
+    thread_local RenderBuffer buffer; // Reused, so repeated displays do not allocate
+    renderInventory(*this, buffer, RenderFormat::TEXT);
+    buffer.flushTo(std::cout);
+}
+
+// Render inventory contents into a caller-owned buffer
+void Inventory::render(RenderBuffer& out, RenderFormat format, std::string_view label) const{
+    renderInventory(*this, out, format, label);
+}
+
+// Iterate over item names in order
+Inventory::const_iterator Inventory::begin() const{
+    return const_iterator(this, 0);
+}
+
+Inventory::const_iterator Inventory::end() const{
+    return const_iterator(this, items.size());
+}
+
+// View item ids as one contiguous block (compacts TOMBSTONE holes first)
+Inventory::IdSpan Inventory::ids(){
+    compact();
+    return IdSpan{items.data(), items.size()};
+}
+
+// Add a batch of names with one capacity check, mask bit is true if added
+std::vector<bool> Inventory::addItems(std::initializer_list<std::string_view> batch){
+    return addItems<std::initializer_list<std::string_view>>(batch);
+}
+
+// Remove a batch of names, mask bit is true if removed
+std::vector<bool> Inventory::removeItems(std::initializer_list<std::string_view> batch){
+    return removeItems<std::initializer_list<std::string_view>>(batch);
+}
+
+// Switch removal policy (rebuilds the hash index)
+void Inventory::setRemovalPolicy(RemovalPolicy policy_i){
+    compact();
+    policy = policy_i;
+    rebuildIndex();
+}
+
+// Get the current removal policy
+RemovalPolicy Inventory::getRemovalPolicy() const{
+    return policy;
+}
+
+// Drop the dead slots left behind by TOMBSTONE removals, never allocates
+void Inventory::compact(){
+    if (tombstones == 0) return;
+    // Every list held at least its live copies, so refilling it stays within its capacity
+    for (auto& entry : slotIndex){
+        entry.second.slots.clear();
+        entry.second.head = 0;
+    }
+    size_t live = 0;
+    for (size_t i = 0; i < items.size(); ++i){
+        if (dead[i]) continue;
+        items[live] = items[i];
+        slotIndex.find(items[live])->second.slots.push_back(live);
+        ++live;
     }
-    std::cout << " ]" << std::endl;
+    items.resize(live);
+    dead.assign(live, false);
+    deadTree.assign(live, 0);
+    tombstones = 0;
+}
+
+// Keep a sorted name index, updated on every add and remove
+void Inventory::enableNameIndex(){
+    if (nameIndexed) return;
+    nameIndex.clear();
+    nameIndexed = true;
+    for (auto it = begin(); it != end(); ++it)
+        indexName(it.id(), 1);
+}
+
+// Drop the name index and stop updating it
+void Inventory::disableNameIndex(){
+    nameIndex.clear();
+    nameIndexed = false;
+}
+
+// True while the name index is kept
+bool Inventory::hasNameIndex() const{
+    return nameIndexed;
+}
+
+// Names starting with prefix
+Inventory::NameRange Inventory::withPrefix(std::string_view prefix) const{
+    requireNameIndex();
+    auto first = nameIndex.lower_bound(prefix);
+
+    // Every name with the prefix sorts below the prefix with its last non-0xFF byte bumped
+    std::string bound(prefix);
+    while (!bound.empty() && static_cast<unsigned char>(bound.back()) == 0xFF)
+        bound.pop_back();
+    if (bound.empty())
+        return NameRange{first, nameIndex.end()};
+    bound.back() = static_cast<char>(static_cast<unsigned char>(bound.back()) + 1);
+    return NameRange{first, nameIndex.lower_bound(std::string_view(bound))};
+}
+
+// Names in [low, high)
+Inventory::NameRange Inventory::inRange(std::string_view low, std::string_view high) const{
+    requireNameIndex();
+    if (!(low < high))
+        return NameRange{nameIndex.end(), nameIndex.end()};
+    return NameRange{nameIndex.lower_bound(low), nameIndex.lower_bound(high)};
+}
+
+// Start recording every add and remove as a numbered delta
+void Inventory::enableJournal(){
+    journaling = true;
+}
+
+// Stop recording and drop the retained deltas; changes keep advancing the sequence number
+void Inventory::disableJournal(){
+    journal.clear();
+    journaling = false;
+}
+
+// True while changes are recorded
+bool Inventory::hasJournal() const{
+    return journaling;
+}
+
+// Sequence number of the last change made or applied
+std::uint64_t Inventory::getJournalSequence() const{
+    return journalSequence;
+}
+
+// Append the deltas after sequence to out, false if they were already compacted away
+bool Inventory::deltasSince(std::uint64_t sequence, std::vector<InventoryDelta>& out) const{
+    if (sequence > journalSequence) return false;
+    if (sequence == journalSequence) return true;
+    if (journal.empty() || sequence + 1 < journal.front().sequence) return false;
+
+    // Sequence numbers are consecutive, so the first delta to send is found by offset
+    auto first = journal.begin() + (sequence + 1 - journal.front().sequence);
+    out.insert(out.end(), first, journal.end());
+    return true;
+}
+
+// Drop retained deltas up to sequence
+void Inventory::compactJournal(std::uint64_t sequence){
+    auto kept = std::find_if(journal.begin(), journal.end(), [sequence](const InventoryDelta& delta){ return delta.sequence > sequence; });
+    journal.erase(journal.begin(), kept);
+}
+
+// Apply deltas from another inventory in order, by name; false on a gap or a mismatch
+bool Inventory::applyDeltas(const std::vector<InventoryDelta>& deltas){
+    for (const InventoryDelta& delta : deltas){
+        if (delta.sequence <= journalSequence) continue; // Overlap after a reconnect
+        if (delta.sequence != journalSequence + 1) return false;
+        if (delta.op == DeltaOp::ADD){
+            if (delta.index != static_cast<std::uint32_t>(getItemCount())) return false; // Not the sender's contents
+            appendId(registry->intern(delta.name));
+        }
+        else{
+            std::optional<ItemId> id = registry->lookup(delta.name);
+            bool removed = id && (delta.op == DeltaOp::MOVE ? removeMoved(*id, delta.index) : removeId(*id));
+            if (!removed) return false; // Receiver does not hold what the sender removed
+        }
+        journalSequence = delta.sequence; // Matches what journalChange counted
+    }
+    return true;
+}
+
+// Append an id that is known to fit; if it throws, nothing changed
+void Inventory::appendId(ItemId item){
+    prepareAppends(&item, 1, 1);
+    commitAppend(item);
+}
+
+// Allocate everything the appends of ids and journalEntries deltas need; if it throws, nothing changed
+void Inventory::prepareAppends(const ItemId* ids, size_t count, size_t journalEntries){
+    // Capacity alone is not observable, so growing it needs no undo
+    growFor(items, count);
+    if (policy == RemovalPolicy::SWAP_AND_POP) growFor(slotPos, count);
+    if (policy == RemovalPolicy::TOMBSTONE){
+        growFor(dead, count);
+        growFor(deadTree, count);
+    }
+    if (journaling) growFor(journal, journalEntries);
+
+    // Index entries are visible, so the ones made here are dropped again on failure
+    size_t i = 0;
+    try{
+        for (; i < count; ++i){
+            if (std::find(ids, ids + i, ids[i]) != ids + i) continue; // Reserved with its first copy
+            size_t copies = std::count(ids + i, ids + count, ids[i]);
+            if (policy != RemovalPolicy::LINEAR) growFor(slotIndex[ids[i]].slots, copies);
+            if (nameIndexed) nameIndex.emplace(registry->name(ids[i]), 0);
+        }
+    }
+    catch (...){
+        unprepareAppends(ids, i + 1);
+        throw;
+    }
+}
+
+// Drop the empty index entries prepareAppends made for ids that will not be appended
+void Inventory::unprepareAppends(const ItemId* ids, size_t count) noexcept{
+    // Outside a prepare, lists and name counts never sit empty, so every empty one found here was made by it
+    for (size_t i = 0; i < count; ++i){
+        if (policy != RemovalPolicy::LINEAR){
+            auto it = slotIndex.find(ids[i]);
+            if (it != slotIndex.end() && it->second.slots.size() == it->second.head)
+                slotIndex.erase(it);
+        }
+        if (nameIndexed){
+            auto it = nameIndex.find(registry->name(ids[i]));
+            if (it != nameIndex.end() && it->second == 0)
+                nameIndex.erase(it);
+        }
+    }
+}
+
+// Append an id readied by prepareAppends, never allocates
+void Inventory::commitAppend(ItemId item) noexcept{
+    items.push_back(item);
+    if (policy == RemovalPolicy::SWAP_AND_POP) slotPos.push_back(0);
+    if (policy == RemovalPolicy::TOMBSTONE){
+        dead.push_back(false);
+        // New Fenwick node covers (n - lowbit(n), n], one-based
+        size_t node = items.size();
+        deadTree.push_back(tombstones == 0 ? 0 : deadBefore(node - 1) - deadBefore(node - (node & (~node + 1))));
+    }
+    if (policy != RemovalPolicy::LINEAR) indexSlot(items.size() - 1);
+    indexName(item, 1);
+    journalChange(DeltaOp::ADD, item, getItemCount() - 1);
+}
+
+// Remove one copy of an id, returns false if not found; if it throws, nothing changed
+bool Inventory::removeId(ItemId item){
+    if (journaling) growFor(journal, 1); // The only allocation a removal can need
+    bool removed = false;
+    if (policy != RemovalPolicy::LINEAR)
+        removed = removeIndexed(item);
+    else{
+        auto it = std::find(items.begin(), items.end(), item);
+        if (it != items.end()){
+            items.erase(it);
+            journalChange(DeltaOp::REMOVE, item, 0);
+            removed = true;
+        }
+    }
+    if (removed) indexName(item, -1);
+    return removed;
+}
+
+// Remove a batch in one stable pass (LINEAR policy)
+std::vector<bool> Inventory::removeBatchLinear(const std::vector<std::optional<ItemId>>& batch){
+    // How many copies of each id the batch asks for
+    std::unordered_map<ItemId, size_t> wanted;
+    for (const auto& id : batch)
+        if (id) ++wanted[*id];
+
+    // Drop the first matching copies, same result as removing one at a time
+    std::unordered_map<ItemId, size_t> taken;
+    size_t live = 0;
+    for (size_t i = 0; i < items.size(); ++i){
+        ItemId id = items[i];
+        auto it = wanted.find(id);
+        if (it != wanted.end() && it->second > 0){
+            --it->second;
+            ++taken[id];
+            indexName(id, -1);
+            continue;
+        }
+        items[live++] = id;
+    }
+    items.resize(live);
+
+    // Hand out the removals in batch order
+    std::vector<bool> removed;
+    removed.reserve(batch.size());
+    for (const auto& id : batch){
+        bool hit = false;
+        if (id){
+            auto it = taken.find(*id);
+            if (it != taken.end() && it->second > 0){
+                --it->second;
+                journalChange(DeltaOp::REMOVE, *id, 0); // Batch order, same result as one at a time
+                hit = true;
+            }
+        }
+        removed.push_back(hit);
+    }
+    return removed;
+}
+
+// Make room for extra appended slots and their journal deltas, growing geometrically
+void Inventory::reserveFor(size_t extra){
+    growFor(items, extra);
+    if (policy == RemovalPolicy::SWAP_AND_POP) growFor(slotPos, extra);
+    if (policy == RemovalPolicy::TOMBSTONE){
+        growFor(dead, extra);
+        growFor(deadTree, extra);
+    }
+    if (journaling) growFor(journal, extra);
+}
+
+// Record a newly appended slot in the hash index
+void Inventory::indexSlot(size_t slot){
+    SlotList& list = slotIndex[items[slot]];
+    if (policy == RemovalPolicy::SWAP_AND_POP) slotPos[slot] = list.slots.size();
+    list.slots.push_back(slot);
+}
+
+// Rebuild the hash index from scratch
+void Inventory::rebuildIndex(){
+    slotIndex.clear();
+    slotPos.clear();
+    dead.clear();
+    deadTree.clear();
+    if (policy == RemovalPolicy::LINEAR) return;
+    if (policy == RemovalPolicy::SWAP_AND_POP) slotPos.resize(items.size());
+    if (policy == RemovalPolicy::TOMBSTONE){
+        dead.resize(items.size(), false);
+        deadTree.resize(items.size(), 0); // Called with no holes, so every count is 0
+    }
+    for (size_t i = 0; i < items.size(); ++i)
+        indexSlot(i);
+}
+
+// Remove one copy of item using the hash index, returns false if not found
+bool Inventory::removeIndexed(ItemId item){
+    auto it = slotIndex.find(item);
+    if (it == slotIndex.end()) return false;
+    SlotList& list = it->second;
+
+    if (policy == RemovalPolicy::SWAP_AND_POP){
+        // Take the newest copy, then move the last item into the freed slot
+        size_t slot = list.slots.back();
+        list.slots.pop_back();
+        if (list.slots.empty()) slotIndex.erase(it);
+        moveLastInto(slot);
+        journalChange(DeltaOp::MOVE, item, slot);
+        return true;
+    }
+
+    // TOMBSTONE: take the oldest copy and leave a hole behind
+    size_t slot = list.slots[list.head++];
+    if (list.head == list.slots.size())
+        slotIndex.erase(it);
+    else if (list.head * 2 >= list.slots.size()){
+        list.slots.erase(list.slots.begin(), list.slots.begin() + list.head);
+        list.head = 0;
+    }
+    dead[slot] = true;
+    markDead(slot);
+    ++tombstones;
+    journalChange(DeltaOp::REMOVE, item, 0);
+    if (tombstones * 2 > items.size()) compact(); // Keeps compaction O(1) amortized
+    return true;
+}
+
+// Remove the copy of item at index and move the last item into its place, false if item is not there
+bool Inventory::removeMoved(ItemId item, size_t index){
+    if (policy == RemovalPolicy::TOMBSTONE) return removeId(item); // Holes keep order, so the move cannot be mirrored
+    if (index >= items.size() || items[index] != item) return false;
+    if (journaling) growFor(journal, 1);
+
+    if (policy == RemovalPolicy::SWAP_AND_POP){
+        // Take this exact copy out of its list, the list's last entry fills its place
+        auto it = slotIndex.find(item);
+        SlotList& list = it->second;
+        size_t pos = slotPos[index];
+        list.slots[pos] = list.slots.back();
+        slotPos[list.slots[pos]] = pos;
+        list.slots.pop_back();
+        if (list.slots.empty()) slotIndex.erase(it);
+        moveLastInto(index);
+    }
+    else{
+        items[index] = items.back();
+        items.pop_back();
+    }
+    indexName(item, -1);
+    journalChange(DeltaOp::MOVE, item, index);
+    return true;
+}
+
+// Move the last item into slot and drop the last slot (SWAP_AND_POP)
+void Inventory::moveLastInto(size_t slot){
+    size_t last = items.size() - 1;
+    if (slot != last){
+        items[slot] = items[last];
+        slotIndex.find(items[slot])->second.slots[slotPos[last]] = slot;
+        slotPos[slot] = slotPos[last];
+    }
+    items.pop_back();
+    slotPos.pop_back();
+}
+
+// Find the physical slot of the index-th live item, or -1
+long Inventory::physicalSlot(int index) const{
+    if (index < 0) return -1;
+    if (static_cast<size_t>(index) >= items.size() - tombstones) return -1;
+    if (tombstones == 0) return index;
+
+    // Descend the Fenwick tree: take every block whose live items all come before the one wanted
+    size_t slot = 0;
+    size_t skip = index;
+    size_t step = 1;
+    while (step * 2 <= items.size()) step *= 2;
+    for (; step > 0; step /= 2){
+        if (slot + step > items.size()) continue;
+        size_t live = step - deadTree[slot + step - 1];
+        if (live <= skip){
+            slot += step;
+            skip -= live;
+        }
+    }
+    return slot;
+}
+
+// Mark a slot dead in the Fenwick tree
+void Inventory::markDead(size_t slot){
+    for (size_t node = slot + 1; node <= deadTree.size(); node += node & (~node + 1))
+        ++deadTree[node - 1];
+}
+
+// Count dead slots in [0, end)
+size_t Inventory::deadBefore(size_t end) const{
+    size_t count = 0;
+    for (size_t node = end; node > 0; node -= node & (~node + 1))
+        count += deadTree[node - 1];
+    return count;
+}
+
+// Adjust the name index copy count of one item, no-op while the index is off
+void Inventory::indexName(ItemId item, int delta){
+    if (!nameIndexed) return;
+    std::string_view name = registry->name(item); // Registry names never move, so the view stays valid
+    auto it = nameIndex.find(name);
+    if (it == nameIndex.end()){
+        nameIndex.emplace(name, delta);
+        return;
+    }
+    it->second += delta;
+    if (it->second == 0) nameIndex.erase(it);
+}
+
+// Number one change, and record it while the journal is on
+void Inventory::journalChange(DeltaOp op, ItemId item, size_t index){
+    ++journalSequence; // Counted even while off, so receivers from before a pause see a gap
+    if (!journaling) return;
+    journal.push_back(InventoryDelta{journalSequence, item, registry->name(item), static_cast<std::uint32_t>(index), op});
+}
+
+// Throw unless the name index is enabled
+void Inventory::requireNameIndex() const{
+    if (!nameIndexed)
+        throw std::logic_error("Name index is not enabled, call enableNameIndex() first");
 }
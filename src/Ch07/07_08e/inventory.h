@@ -5,38 +5,372 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <optional>
+#include <iterator>
+#include <initializer_list>
+#include <cstddef>
+#include <unordered_map>
+#include <map>
+#include <cstdint>
+#include <memory_resource>
 #include <algorithm>
 #include <iostream>
+#include "item_registry.h"
+#include "inventory_render.h"
+
+// How the -= operator finds and removes an item
+enum class RemovalPolicy{
+    LINEAR,        // Search and erase, keeps order, O(n) per removal
+    SWAP_AND_POP,  // Hash index lookup, last item fills the hole, O(1) but order is not kept
+    TOMBSTONE      // Hash index lookup, slot marked dead and compacted later, O(1) amortized and order kept
+};
+
+// Kind of change recorded in the change journal
+enum class DeltaOp : std::uint8_t{
+    ADD,     // item appended at the end
+    REMOVE,  // first copy of item removed, order kept (LINEAR, TOMBSTONE)
+    MOVE     // copy at index removed and the last item moved into its place (SWAP_AND_POP)
+};
+
+// One journaled change. Ids belong to the sender's registry; applyDeltas resolves the
+// name instead, so deltas can go to an inventory with another registry or be sent by name
+struct InventoryDelta{
+    std::uint64_t sequence; // Every change is numbered, journaled or not, so unrecorded changes leave a gap
+    ItemId item;            // Item added or removed, in the sender's registry
+    std::string_view name;  // Sender's name for item, valid while the sender's registry lives
+    std::uint32_t index;    // Live index of an ADD or MOVE, checked and used by applyDeltas; 0 for REMOVE
+    DeltaOp op;
+};
 
 class Inventory{
 public:
+    // Allocator for every container the inventory owns; pass a zone's memory_resource to pool them
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    // Forward iterator over item names, skips TOMBSTONE holes and copies nothing
+    class const_iterator{
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string*;
+        using reference = const std::string&;
+
+        const_iterator(): owner(nullptr), slot(0) {}
+
+        reference operator*() const { return owner->registry->name(owner->items[slot]); }
+        pointer operator->() const { return &**this; }
+
+        // Id of the current item, no name lookup
+        ItemId id() const { return owner->items[slot]; }
+
+        const_iterator& operator++(){ ++slot; skipDead(); return *this; }
+        const_iterator operator++(int){ const_iterator old = *this; ++*this; return old; }
+
+        bool operator==(const const_iterator& other) const { return slot == other.slot; }
+        bool operator!=(const const_iterator& other) const { return slot != other.slot; }
+
+    private:
+        friend class Inventory;
+        const_iterator(const Inventory* owner_i, size_t slot_i): owner(owner_i), slot(slot_i) { skipDead(); }
+
+        // Advance past dead slots
+        void skipDead(){
+            while (owner->tombstones > 0 && slot < owner->items.size() && owner->dead[slot]) ++slot;
+        }
+
+        const Inventory* owner;
+        size_t slot;
+    };
+
+    // Contiguous read-only view over item ids (stand-in for std::span under C++17)
+    struct IdSpan{
+        const ItemId* first;
+        size_t count;
+
+        const ItemId* begin() const { return first; }
+        const ItemId* end() const { return first + count; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        ItemId operator[](size_t i) const { return first[i]; }
+    };
+
+    // Sorted item names with their copy counts, kept only when the name index is enabled
+    using NameIndex = std::pmr::map<std::string_view, int, std::less<>>;
+
+    // Half-open run of name index entries, each one a (name, copies) pair in name order
+    struct NameRange{
+        NameIndex::const_iterator first;
+        NameIndex::const_iterator last;
+
+        NameIndex::const_iterator begin() const { return first; }
+        NameIndex::const_iterator end() const { return last; }
+        bool empty() const { return first == last; }
+    };
+
     // Constructor
     Inventory();
 
     // Overloaded Constructor
     Inventory(int capacity_i);
 
-    // Destructor
-    ~Inventory();
+    // Overloaded Constructor with a removal policy
+    Inventory(int capacity_i, RemovalPolicy policy_i);
+
+    // Overloaded Constructor with a removal policy and a per-world registry
+    Inventory(int capacity_i, RemovalPolicy policy_i, ItemRegistry& registry_i);
+
+    // Allocator-extended Constructors, used directly or by std::pmr containers of inventories
+    explicit Inventory(const allocator_type& alloc);
+    Inventory(int capacity_i, const allocator_type& alloc);
+    Inventory(int capacity_i, RemovalPolicy policy_i, const allocator_type& alloc);
+    Inventory(int capacity_i, RemovalPolicy policy_i, ItemRegistry& registry_i, const allocator_type& alloc);
+
+    // Copy and move are member-wise; the registry is shared, not copied
+    Inventory(const Inventory& other) = default;
+    Inventory(const Inventory& other, const allocator_type& alloc);
+    Inventory& operator=(const Inventory& other) = default;
+    Inventory(Inventory&& other) noexcept;
+    Inventory(Inventory&& other, const allocator_type& alloc);
+    Inventory& operator=(Inventory&& other);
+    ~Inventory() = default;
+
+    // Get the allocator the inventory's containers use
+    allocator_type get_allocator() const;
 
     // Add item to inventory
     Inventory& operator+=(const std::string& item);
+    Inventory& operator+=(ItemId item);
 
     // Remove item from inventory
     Inventory& operator-=(const std::string& item);
+    Inventory& operator-=(ItemId item);
 
-    // Access item by index
-    std::string operator[](int index) const;
+    // Access item by index, returns "Index out of bounds" on a miss
+    const std::string& operator[](int index) const;
+
+    // Access item by index without bounds reporting (index must be valid)
+    std::string_view itemAt(int index) const;
+
+    // Access item by index, nullopt when out of bounds
+    std::optional<std::string_view> tryGetItem(int index) const;
+
+    // Access item id by index, nullopt when out of bounds
+    std::optional<ItemId> getItemId(int index) const;
+
+    // Get the registry that resolves this inventory's ids
+    ItemRegistry& getRegistry() const;
 
     // Get number of items in the inventory
     int getItemCount() const;
 
+    // Get maximum number of items allowed
+    int getCapacity() const;
+
+    // Get number of copies of one item, O(1) under the indexed policies
+    int countOf(ItemId item) const;
+
     // Display inventory contents
     void displayInventory() const;
 
+    // Render inventory contents into a caller-owned buffer, no output is written
+    void render(RenderBuffer& out, RenderFormat format, std::string_view label = "Inventory") const;
+
+    // Iterate over item names in order
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // View item ids as one contiguous block (compacts TOMBSTONE holes first)
+    IdSpan ids();
+
+    // Add a batch of names or ids with one capacity check, mask bit is true if added
+    template<typename Range>
+    std::vector<bool> addItems(const Range& batch);
+    std::vector<bool> addItems(std::initializer_list<std::string_view> batch);
+
+    // Remove a batch of names or ids, mask bit is true if removed
+    template<typename Range>
+    std::vector<bool> removeItems(const Range& batch);
+    std::vector<bool> removeItems(std::initializer_list<std::string_view> batch);
+
+    // Switch removal policy (rebuilds the hash index)
+    void setRemovalPolicy(RemovalPolicy policy_i);
+
+    // Get the current removal policy
+    RemovalPolicy getRemovalPolicy() const;
+
+    // Drop the dead slots left behind by TOMBSTONE removals, O(n) and never allocates
+    void compact();
+
+    // Keep a sorted name index, updated on every add and remove (built once from the current items)
+    void enableNameIndex();
+
+    // Drop the name index and stop updating it
+    void disableNameIndex();
+
+    // True while the name index is kept
+    bool hasNameIndex() const;
+
+    // Names starting with prefix, O(log n) plus the names returned; throws std::logic_error without the index
+    NameRange withPrefix(std::string_view prefix) const;
+
+    // Names in [low, high), O(log n) plus the names returned; throws std::logic_error without the index
+    NameRange inRange(std::string_view low, std::string_view high) const;
+
+    // Start recording every add and remove as a numbered delta
+    void enableJournal();
+
+    // Stop recording and drop the retained deltas; changes keep advancing the sequence number,
+    // so a receiver behind the point of re-enabling gets false from deltasSince
+    void disableJournal();
+
+    // True while changes are recorded
+    bool hasJournal() const;
+
+    // Sequence number of the last change made or applied, 0 before any
+    std::uint64_t getJournalSequence() const;
+
+    // Append the deltas after sequence to out, false if they were already compacted away (resend everything)
+    bool deltasSince(std::uint64_t sequence, std::vector<InventoryDelta>& out) const;
+
+    // Drop retained deltas up to sequence, once every receiver has applied them
+    void compactJournal(std::uint64_t sequence);
+
+    // Apply deltas from another inventory in order, by name; already applied ones are skipped.
+    // Returns false and stops at a gap, or where this inventory no longer matches the sender.
+    // Order matches the sender when both use the same policy, when both keep order (LINEAR,
+    // TOMBSTONE), or when a LINEAR inventory receives from a SWAP_AND_POP one
+    bool applyDeltas(const std::vector<InventoryDelta>& deltas);
+
 private:
-    std::vector<std::string> *items; // Pointer to a vector of items
+    friend class Trade; // Applies validated steps without the printing operators
+
+    // Physical slots holding copies of one item
+    struct SlotList{
+        using allocator_type = std::pmr::polymorphic_allocator<size_t>;
+
+        explicit SlotList(const allocator_type& alloc): slots(alloc), head(0) {}
+        SlotList(const SlotList& other, const allocator_type& alloc): slots(other.slots, alloc), head(other.head) {}
+        SlotList(SlotList&& other, const allocator_type& alloc): slots(std::move(other.slots), alloc), head(other.head) {}
+
+        std::pmr::vector<size_t> slots; // Indices into items, ascending under TOMBSTONE
+        size_t head;                    // TOMBSTONE removes from the front, like the linear search would
+    };
+
+    // Append an id that is known to fit; if it throws, nothing changed
+    void appendId(ItemId item);
+
+    // Allocate everything appending ids[0..count) and recording journalEntries deltas needs,
+    // so the matching commitAppend calls cannot throw; if it throws, nothing changed.
+    // O(count^2) in the batch, meant for the handful of ids one trade moves
+    void prepareAppends(const ItemId* ids, size_t count, size_t journalEntries);
+
+    // Drop the empty index entries prepareAppends made for ids that will not be appended
+    void unprepareAppends(const ItemId* ids, size_t count) noexcept;
+
+    // Append an id readied by prepareAppends, never allocates
+    void commitAppend(ItemId item) noexcept;
+
+    // Remove one copy of an id, returns false if not found; if it throws, nothing changed.
+    // Never allocates once the journal has room for one more delta
+    bool removeId(ItemId item);
+
+    // Remove a batch in one stable pass (LINEAR policy)
+    std::vector<bool> removeBatchLinear(const std::vector<std::optional<ItemId>>& batch);
+
+    // Make room for extra appended slots and their journal deltas, growing geometrically
+    void reserveFor(size_t extra);
+
+    // Batch element conversions
+    ItemId toId(std::string_view name) { return registry->intern(name); }
+    ItemId toId(ItemId id) { return id; }
+    std::optional<ItemId> findId(std::string_view name) const { return registry->lookup(name); }
+    std::optional<ItemId> findId(ItemId id) const { return id; }
+
+    // Record a newly appended slot in the hash index
+    void indexSlot(size_t slot);
+
+    // Rebuild the hash index from scratch
+    void rebuildIndex();
+
+    // Remove one copy of item using the hash index, returns false if not found
+    bool removeIndexed(ItemId item);
+
+    // Remove the copy of item at index and move the last item into its place, as a sender's
+    // SWAP_AND_POP did; false if item is not there. TOMBSTONE removes the first copy instead
+    bool removeMoved(ItemId item, size_t index);
+
+    // Move the last item into slot and drop the last slot (SWAP_AND_POP)
+    void moveLastInto(size_t slot);
+
+    // Find the physical slot of the index-th live item, or -1; O(log n) while holes exist
+    long physicalSlot(int index) const;
+
+    // Fenwick tree over dead: mark a slot dead, or count dead slots in [0, end)
+    void markDead(size_t slot);
+    size_t deadBefore(size_t end) const;
+
+    // Adjust the name index copy count of one item, no-op while the index is off
+    void indexName(ItemId item, int delta);
+
+    // Throw unless the name index is enabled
+    void requireNameIndex() const;
+
+    // Number one change, and record it while the journal is on
+    void journalChange(DeltaOp op, ItemId item, size_t index);
+
+    std::pmr::vector<ItemId> items; // Interned item ids, held by value
     int capacity; // Maximum number of items allowed
+    RemovalPolicy policy; // How items are removed
+    ItemRegistry* registry; // Resolves ids to names, never null
+    std::pmr::unordered_map<ItemId, SlotList> slotIndex; // Item to slots, unused under LINEAR
+    std::pmr::vector<size_t> slotPos; // Position of each slot inside its SlotList (SWAP_AND_POP)
+    std::pmr::vector<bool> dead; // Slots removed but not compacted yet (TOMBSTONE)
+    size_t tombstones; // Number of dead slots
+    std::pmr::vector<size_t> deadTree; // Fenwick tree of dead counts, one node per slot (TOMBSTONE)
+    NameIndex nameIndex; // Name to copy count, views into the registry's stable names
+    bool nameIndexed; // Whether nameIndex is kept up to date
+    std::pmr::vector<InventoryDelta> journal; // Retained deltas, consecutive sequence numbers; a vector so room can be reserved
+    std::uint64_t journalSequence; // Last change recorded or applied
+    bool journaling; // Whether changes are recorded
 };
 
+// Add a batch of names or ids with one capacity check, mask bit is true if added
+template<typename Range>
+std::vector<bool> Inventory::addItems(const Range& batch){
+    size_t count = std::distance(std::begin(batch), std::end(batch));
+    size_t room = capacity > getItemCount() ? capacity - getItemCount() : 0;
+    reserveFor(std::min(count, room));
+
+    std::vector<bool> added;
+    added.reserve(count);
+    for (const auto& item : batch){
+        bool fits = room > 0;
+        if (fits){
+            appendId(toId(item));
+            --room;
+        }
+        added.push_back(fits);
+    }
+    return added;
+}
+
+// Remove a batch of names or ids, mask bit is true if removed
+template<typename Range>
+std::vector<bool> Inventory::removeItems(const Range& batch){
+    std::vector<std::optional<ItemId>> found;
+    found.reserve(std::distance(std::begin(batch), std::end(batch)));
+    for (const auto& item : batch)
+        found.push_back(findId(item));
+    if (policy == RemovalPolicy::LINEAR)
+        return removeBatchLinear(found);
+
+    std::vector<bool> removed;
+    removed.reserve(found.size());
+    for (const auto& id : found)
+        removed.push_back(id && removeId(*id));
+    return removed;
+}
+
 #endif // INVENTORY_H
@@ -0,0 +1,48 @@
+#include "inventory_render.h"
+
+// Append text as the body of a JSON string
+void RenderBuffer::appendJsonEscaped(std::string_view text){
+    static const char hex[] = "0123456789abcdef";
+    for (char c : text){
+        switch (c){
+            case '"':  data.append("\\\""); break;
+            case '\\': data.append("\\\\"); break;
+            case '\n': data.append("\\n"); break;
+            case '\r': data.append("\\r"); break;
+            case '\t': data.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20){
+                    data.append("\\u00");
+                    data.push_back(hex[(c >> 4) & 0xF]);
+                    data.push_back(hex[c & 0xF]);
+                }
+                else
+                    data.push_back(c);
+        }
+    }
+}
+
+// Append text as one CSV field, quoted only when needed
+void RenderBuffer::appendCsvField(std::string_view text){
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos){
+        data.append(text.data(), text.size());
+        return;
+    }
+    data.push_back('"');
+    for (char c : text){
+        if (c == '"') data.push_back('"'); // Quotes are doubled inside a quoted field
+        data.push_back(c);
+    }
+    data.push_back('"');
+}
+
+// Write everything buffered in a single call, then clear
+void RenderBuffer::flushTo(std::ostream& out){
+    out.write(data.data(), data.size());
+    data.clear();
+}
+
+void RenderBuffer::flushTo(std::FILE* out){
+    std::fwrite(data.data(), 1, data.size(), out);
+    data.clear();
+}
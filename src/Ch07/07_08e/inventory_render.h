@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef INVENTORY_RENDER_H
+#define INVENTORY_RENDER_H
+
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include <ostream>
+
+// Output formats for rendering inventories
+enum class RenderFormat{
+    TEXT,  // Inventory: [ A, B ]
+    JSON,  // {"owner":"Inventory","items":["A","B"]}
+    CSV    // Inventory,A,B
+};
+
+// Reusable output buffer. clear() keeps the capacity, so once it has grown
+// to the size of a batch, rendering more batches allocates nothing.
+class RenderBuffer{
+public:
+    // Append raw text
+    void append(std::string_view text) { data.append(text.data(), text.size()); }
+    void append(char c) { data.push_back(c); }
+
+    // Append text as the body of a JSON string
+    void appendJsonEscaped(std::string_view text);
+
+    // Append text as one CSV field, quoted only when needed
+    void appendCsvField(std::string_view text);
+
+    // Get the buffered bytes
+    std::string_view view() const { return data; }
+    size_t size() const { return data.size(); }
+
+    // Drop the contents but keep the memory
+    void clear() { data.clear(); }
+
+    // Write everything buffered in a single call, then clear
+    void flushTo(std::ostream& out);
+    void flushTo(std::FILE* out);
+
+private:
+    std::string data;
+};
+
+// Render any range of item names (Inventory, InlineInventory, ...) into a buffer
+template<typename Range>
+void renderInventory(const Range& items, RenderBuffer& out, RenderFormat format, std::string_view label = "Inventory"){
+    bool first = true;
+    switch (format){
+        case RenderFormat::TEXT:
+            out.append(label);
+            out.append(": [ ");
+            for (const auto& item : items){
+                if (!first) out.append(", ");
+                out.append(item);
+                first = false;
+            }
+            out.append(" ]\n");
+            break;
+
+        case RenderFormat::JSON:
+            out.append("{\"owner\":\"");
+            out.appendJsonEscaped(label);
+            out.append("\",\"items\":[");
+            for (const auto& item : items){
+                if (!first) out.append(',');
+                out.append('"');
+                out.appendJsonEscaped(item);
+                out.append('"');
+                first = false;
+            }
+            out.append("]}\n");
+            break;
+
+        case RenderFormat::CSV:
+            out.appendCsvField(label);
+            for (const auto& item : items){
+                out.append(',');
+                out.appendCsvField(item);
+            }
+            out.append('\n');
+            break;
+    }
+}
+
+#endif // INVENTORY_RENDER_H
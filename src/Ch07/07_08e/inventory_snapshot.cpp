@@ -0,0 +1,244 @@
+#include "inventory_snapshot.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INVENTORY_SNAPSHOT_MMAP 1
+#endif
+
+namespace {
+    const char MAGIC[8] = {'I', 'N', 'V', 'S', 'N', 'A', 'P', '1'};
+    const std::uint32_t FORMAT_VERSION = 1;
+
+    // Round up to the next multiple of 8
+    std::uint64_t align8(std::uint64_t offset){
+        return (offset + 7) & ~std::uint64_t(7);
+    }
+
+    // True if count elements of size bytes starting at offset end at or before limit, without overflowing
+    bool fits(std::uint64_t offset, std::uint64_t count, std::uint64_t size, std::uint64_t limit){
+        return offset <= limit && count <= (limit - offset) / size;
+    }
+
+    // Write raw bytes, then zero padding up to an 8-byte boundary
+    void writePadded(std::ofstream& out, const void* data, size_t size){
+        static const char zeros[8] = {};
+        out.write(static_cast<const char*>(data), size);
+        out.write(zeros, align8(size) - size);
+    }
+}
+
+// Write inventories to a snapshot file, throws std::runtime_error on I/O failure
+void InventorySnapshot::write(const std::string& path, const std::vector<const Inventory*>& inventories){
+    // Give every distinct (registry, id) pair a file-local name index
+    std::vector<std::string_view> nameList;
+    std::unordered_map<const ItemRegistry*, std::unordered_map<ItemId, std::uint32_t>> nameIndex;
+    std::vector<Record> recordList;
+    std::vector<std::uint32_t> itemList;
+    std::uint64_t stringsSize = 0;
+
+    for (const Inventory* inventory : inventories){
+        const ItemRegistry& registry = inventory->getRegistry();
+        auto& local = nameIndex[&registry];
+        Record record{itemList.size(), 0, inventory->getCapacity(), static_cast<std::uint32_t>(inventory->getRemovalPolicy()), 0};
+        for (auto it = inventory->begin(); it != inventory->end(); ++it){
+            auto found = local.find(it.id());
+            if (found == local.end()){
+                found = local.emplace(it.id(), static_cast<std::uint32_t>(nameList.size())).first;
+                nameList.push_back(*it);
+                stringsSize += it->size();
+            }
+            itemList.push_back(found->second);
+            ++record.itemCount;
+        }
+        recordList.push_back(record);
+    }
+    // Name table entries and the name count are 32-bit
+    if (stringsSize > std::numeric_limits<std::uint32_t>::max() || nameList.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error("Too many item names for one snapshot: " + path);
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.nameCount = nameList.size();
+    header.inventoryCount = recordList.size();
+    header.itemCount = itemList.size();
+    header.nameTableOffset = align8(sizeof(Header));
+    header.stringsOffset = header.nameTableOffset + align8(nameList.size() * sizeof(NameEntry));
+    header.recordsOffset = header.stringsOffset + align8(stringsSize);
+    header.itemsOffset = header.recordsOffset + align8(recordList.size() * sizeof(Record));
+    header.fileSize = header.itemsOffset + align8(itemList.size() * sizeof(std::uint32_t));
+
+    std::vector<NameEntry> nameTable;
+    std::string blob;
+    nameTable.reserve(nameList.size());
+    blob.reserve(stringsSize);
+    for (std::string_view name : nameList){
+        nameTable.push_back(NameEntry{static_cast<std::uint32_t>(blob.size()), static_cast<std::uint32_t>(name.size())});
+        blob.append(name.data(), name.size());
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Cannot open snapshot for writing: " + path);
+    writePadded(out, &header, sizeof(Header));
+    writePadded(out, nameTable.data(), nameTable.size() * sizeof(NameEntry));
+    writePadded(out, blob.data(), blob.size());
+    writePadded(out, recordList.data(), recordList.size() * sizeof(Record));
+    writePadded(out, itemList.data(), itemList.size() * sizeof(std::uint32_t));
+    if (!out)
+        throw std::runtime_error("Failed writing snapshot: " + path);
+}
+
+// Map a snapshot file, throws std::runtime_error if it is missing or malformed
+InventorySnapshot::InventorySnapshot(const std::string& path): base(nullptr), length(0){
+#ifdef INVENTORY_SNAPSHOT_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open snapshot: " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))){
+        ::close(fd);
+        throw std::runtime_error("Snapshot too small: " + path);
+    }
+    length = info.st_size;
+    void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+    if (mapped == MAP_FAILED)
+        throw std::runtime_error("Cannot map snapshot: " + path);
+    base = static_cast<const char*>(mapped);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Cannot open snapshot: " + path);
+    fallback.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    base = fallback.data();
+    length = fallback.size();
+#endif
+    header = reinterpret_cast<const Header*>(base);
+    try{
+        validateHeader();
+    }
+    catch (...){
+#ifdef INVENTORY_SNAPSHOT_MMAP
+        ::munmap(const_cast<char*>(base), length);
+#endif
+        throw;
+    }
+    names = reinterpret_cast<const NameEntry*>(base + header->nameTableOffset);
+    strings = base + header->stringsOffset;
+    records = reinterpret_cast<const Record*>(base + header->recordsOffset);
+    items = reinterpret_cast<const std::uint32_t*>(base + header->itemsOffset);
+}
+
+// Unmap the file
+InventorySnapshot::~InventorySnapshot(){
+#ifdef INVENTORY_SNAPSHOT_MMAP
+    ::munmap(const_cast<char*>(base), length);
+#endif
+}
+
+// Get number of inventories in the file
+size_t InventorySnapshot::getInventoryCount() const{
+    return header->inventoryCount;
+}
+
+// Get number of items in one inventory
+size_t InventorySnapshot::getItemCount(size_t inventory) const{
+    return record(inventory).itemCount;
+}
+
+// Read an item name straight from the mapping
+std::string_view InventorySnapshot::getItemName(size_t inventory, size_t index) const{
+    return getName(itemName(record(inventory), index));
+}
+
+// Get number of distinct names in the file
+size_t InventorySnapshot::getNameCount() const{
+    return header->nameCount;
+}
+
+// Read one name from the name table
+std::string_view InventorySnapshot::getName(std::uint32_t nameIndex) const{
+    if (nameIndex >= header->nameCount)
+        throw std::out_of_range("Snapshot name index out of range");
+    const NameEntry& entry = names[nameIndex];
+    if (std::uint64_t(entry.offset) + entry.length > header->recordsOffset - header->stringsOffset)
+        throw std::runtime_error("Inventory snapshot name lies outside the string blob");
+    return std::string_view(strings + entry.offset, entry.length);
+}
+
+// Build a live Inventory from one record
+Inventory InventorySnapshot::load(size_t inventory) const{
+    return load(inventory, ItemRegistry::global());
+}
+
+Inventory InventorySnapshot::load(size_t inventory, ItemRegistry& registry) const{
+    const Record& checked = record(inventory);
+    if (checked.itemCount > static_cast<std::uint32_t>(checked.capacity))
+        throw std::runtime_error("Inventory snapshot record holds more items than its capacity");
+
+    std::vector<ItemId> batch;
+    batch.reserve(checked.itemCount);
+    {
+        // Each name is interned the first time any load into this registry needs it
+        std::lock_guard<std::mutex> lock(idMutex);
+        std::vector<std::optional<ItemId>>& ids = idCache[&registry];
+        ids.resize(header->nameCount);
+        for (std::uint32_t i = 0; i < checked.itemCount; ++i){
+            std::uint32_t nameIndex = itemName(checked, i);
+            if (!ids[nameIndex])
+                ids[nameIndex] = registry.intern(getName(nameIndex));
+            batch.push_back(*ids[nameIndex]);
+        }
+    }
+
+    Inventory result(checked.capacity, static_cast<RemovalPolicy>(checked.policy), registry);
+    result.addItems(batch);
+    return result;
+}
+
+// Check the header and that every section lies inside the file
+void InventorySnapshot::validateHeader() const{
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error("Not an inventory snapshot");
+    if (header->version != FORMAT_VERSION)
+        throw std::runtime_error("Unsupported inventory snapshot version");
+    if (header->fileSize > length
+        || header->nameTableOffset % 8 != 0 || header->recordsOffset % 8 != 0 || header->itemsOffset % 8 != 0
+        || header->nameTableOffset < sizeof(Header)
+        || !fits(header->nameTableOffset, header->nameCount, sizeof(NameEntry), header->stringsOffset)
+        || header->stringsOffset > header->recordsOffset
+        || !fits(header->recordsOffset, header->inventoryCount, sizeof(Record), header->itemsOffset)
+        || !fits(header->itemsOffset, header->itemCount, sizeof(std::uint32_t), header->fileSize))
+        throw std::runtime_error("Inventory snapshot is truncated or corrupt");
+}
+
+// One record, checked against the item table and the removal policies
+const InventorySnapshot::Record& InventorySnapshot::record(size_t inventory) const{
+    if (inventory >= header->inventoryCount)
+        throw std::out_of_range("Snapshot inventory index out of range");
+    const Record& checked = records[inventory];
+    if (checked.firstItem > header->itemCount || checked.itemCount > header->itemCount - checked.firstItem)
+        throw std::runtime_error("Inventory snapshot record points outside the item table");
+    if (checked.policy > static_cast<std::uint32_t>(RemovalPolicy::TOMBSTONE) || checked.capacity < 0)
+        throw std::runtime_error("Inventory snapshot record has invalid settings");
+    return checked;
+}
+
+// File-local name index of one item of a checked record
+std::uint32_t InventorySnapshot::itemName(const Record& checked, size_t index) const{
+    if (index >= checked.itemCount)
+        throw std::out_of_range("Snapshot item index out of range");
+    std::uint32_t nameIndex = items[checked.firstItem + index];
+    if (nameIndex >= header->nameCount)
+        throw std::runtime_error("Inventory snapshot item has no name");
+    return nameIndex;
+}
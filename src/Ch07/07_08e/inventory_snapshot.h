@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef INVENTORY_SNAPSHOT_H
+#define INVENTORY_SNAPSHOT_H
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <string_view>
+#include "inventory.h"
+#include "item_registry.h"
+
+// Read-only binary snapshot of many inventories, memory-mapped and used in place.
+//
+// Layout (native byte order, every section 8-byte aligned):
+//   Header
+//   NameEntry[nameCount]      offset/length of each distinct name in the string blob
+//   char[]                    string blob
+//   Record[inventoryCount]    where each inventory's items start, plus its settings
+//   uint32_t[itemCount]       item names as indices into the name table
+//
+// Names are stored once per file, so loading interns each distinct name once
+// and then copies ids; nothing is parsed item by item.
+// Name offsets and per-inventory item counts are 32-bit, so write() refuses
+// string blobs or inventories that do not fit them.
+class InventorySnapshot{
+public:
+    // Write inventories to a snapshot file, throws std::runtime_error on I/O failure
+    static void write(const std::string& path, const std::vector<const Inventory*>& inventories);
+
+    // Map a snapshot file, throws std::runtime_error if it is missing or its header is malformed.
+    // Only the header and section table are checked here, so opening costs the same for any file
+    // size and touches one page. Each record, item and name is checked when a getter or load()
+    // reads it, and a damaged one throws std::runtime_error then.
+    explicit InventorySnapshot(const std::string& path);
+
+    // Unmap the file
+    ~InventorySnapshot();
+
+    // A snapshot owns its mapping
+    InventorySnapshot(const InventorySnapshot&) = delete;
+    InventorySnapshot& operator=(const InventorySnapshot&) = delete;
+
+    // Get number of inventories in the file
+    size_t getInventoryCount() const;
+
+    // Get number of items in one inventory, throws std::out_of_range for a bad inventory
+    size_t getItemCount(size_t inventory) const;
+
+    // Read an item name straight from the mapping, throws std::out_of_range for a bad index
+    std::string_view getItemName(size_t inventory, size_t index) const;
+
+    // Get number of distinct names in the file
+    size_t getNameCount() const;
+
+    // Read one name from the name table, throws std::out_of_range for a bad index
+    std::string_view getName(std::uint32_t nameIndex) const;
+
+    // Build a live Inventory from one record; a record holding more items than its capacity
+    // is rejected as corrupt rather than loaded short
+    Inventory load(size_t inventory) const;
+    Inventory load(size_t inventory, ItemRegistry& registry) const;
+
+private:
+    struct Header{
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t nameCount;
+        std::uint64_t inventoryCount;
+        std::uint64_t itemCount;
+        std::uint64_t nameTableOffset;
+        std::uint64_t stringsOffset;
+        std::uint64_t recordsOffset;
+        std::uint64_t itemsOffset;
+        std::uint64_t fileSize;
+    };
+
+    struct NameEntry{
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    struct Record{
+        std::uint64_t firstItem;
+        std::uint32_t itemCount;
+        std::int32_t capacity;
+        std::uint32_t policy;
+        std::uint32_t reserved;
+    };
+
+    // Check the header and that every section lies inside the file
+    void validateHeader() const;
+
+    // One record, checked against the item table and the removal policies
+    const Record& record(size_t inventory) const;
+
+    // File-local name index of one item of a checked record
+    std::uint32_t itemName(const Record& record, size_t index) const;
+
+    const char* base; // Start of the mapping
+    size_t length; // Bytes mapped
+    std::vector<char> fallback; // File contents when mmap is not available
+    const Header* header;
+    const NameEntry* names;
+    const char* strings;
+    const Record* records;
+    const std::uint32_t* items;
+    mutable std::mutex idMutex; // Guards idCache, so concurrent loads are safe
+    mutable std::unordered_map<const ItemRegistry*, std::vector<std::optional<ItemId>>> idCache; // Name index to id, per registry, filled as names are first loaded
+};
+
+#endif // INVENTORY_SNAPSHOT_H
@@ -0,0 +1,86 @@
+#include "item_registry.h"
+#include <mutex>
+
+// Constructor
+ItemRegistry::ItemRegistry(): count(0){
+    directories.push_back(makeDirectory(16));
+    directory.store(directories.back().get(), std::memory_order_release);
+}
+
+// Get the id for a name, adding the name if it is new
+ItemId ItemRegistry::intern(std::string_view name){
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end())
+            return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(name); // Another thread may have added it meanwhile
+    if (it != ids.end())
+        return it->second;
+
+    std::uint32_t index = count.load(std::memory_order_relaxed);
+    size_t chunk = index >> CHUNK_BITS;
+    Directory* dir = directory.load(std::memory_order_relaxed);
+    if (chunk >= dir->capacity){
+        // Readers may still hold the old directory, so copy instead of resizing in place
+        directories.push_back(makeDirectory(dir->capacity * 2));
+        Directory* bigger = directories.back().get();
+        for (size_t i = 0; i < dir->capacity; ++i)
+            bigger->chunks[i].store(dir->chunks[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        directory.store(bigger, std::memory_order_release);
+        dir = bigger;
+    }
+    std::string* slots = dir->chunks[chunk].load(std::memory_order_relaxed);
+    if (slots == nullptr){
+        chunks.push_back(std::make_unique<std::string[]>(CHUNK_SIZE));
+        slots = chunks.back().get();
+        dir->chunks[chunk].store(slots, std::memory_order_release);
+    }
+
+    std::string& stored = slots[index & (CHUNK_SIZE - 1)];
+    stored.assign(name.data(), name.size());
+    ItemId id{index};
+    ids.emplace(stored, id);
+    count.store(index + 1, std::memory_order_release);
+    return id;
+}
+
+// Get the id for a name without adding it
+std::optional<ItemId> ItemRegistry::lookup(std::string_view name) const{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(name);
+    if (it != ids.end())
+        return it->second;
+    return std::nullopt;
+}
+
+// Resolve an id back to its name
+const std::string& ItemRegistry::name(ItemId id) const{
+    Directory* dir = directory.load(std::memory_order_acquire);
+    std::string* slots = dir->chunks[id.value >> CHUNK_BITS].load(std::memory_order_acquire);
+    return slots[id.value & (CHUNK_SIZE - 1)];
+}
+
+// Get number of distinct names
+size_t ItemRegistry::size() const{
+    return count.load(std::memory_order_acquire);
+}
+
+// Registry shared by inventories that are not given their own
+ItemRegistry& ItemRegistry::global(){
+    static ItemRegistry registry;
+    return registry;
+}
+
+// Make a directory with room for capacity chunks
+std::unique_ptr<ItemRegistry::Directory> ItemRegistry::makeDirectory(size_t capacity){
+    auto dir = std::make_unique<Directory>();
+    dir->chunks = std::make_unique<std::atomic<std::string*>[]>(capacity);
+    for (size_t i = 0; i < capacity; ++i)
+        dir->chunks[i].store(nullptr, std::memory_order_relaxed);
+    dir->capacity = capacity;
+    return dir;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef ITEM_REGISTRY_H
+#define ITEM_REGISTRY_H
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <optional>
+#include <functional>
+
+// Compact handle to an interned item name
+struct ItemId{
+    std::uint32_t value;
+
+    bool operator==(ItemId other) const { return value == other.value; }
+    bool operator!=(ItemId other) const { return value != other.value; }
+};
+
+// Hash support so ItemId can key unordered containers
+namespace std{
+    template<>
+    struct hash<ItemId>{
+        size_t operator()(ItemId id) const noexcept { return hash<uint32_t>()(id.value); }
+    };
+}
+
+// Stores each distinct item name once and hands out 32-bit ids for it.
+// Safe to share between threads: intern/lookup take a reader-writer lock, name() takes none.
+class ItemRegistry{
+public:
+    // Constructor
+    ItemRegistry();
+
+    // A registry owns its names and is shared by reference, never copied
+    ItemRegistry(const ItemRegistry&) = delete;
+    ItemRegistry& operator=(const ItemRegistry&) = delete;
+
+    // Get the id for a name, adding the name if it is new
+    ItemId intern(std::string_view name);
+
+    // Get the id for a name without adding it
+    std::optional<ItemId> lookup(std::string_view name) const;
+
+    // Resolve an id back to its name
+    const std::string& name(ItemId id) const;
+
+    // Get number of distinct names
+    size_t size() const;
+
+    // Registry shared by inventories that are not given their own
+    static ItemRegistry& global();
+
+private:
+    // Names live in fixed-size chunks so they never move once written
+    static constexpr size_t CHUNK_BITS = 10;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+
+    // Table of chunk pointers; replaced by a bigger copy when full, old tables kept until destruction
+    struct Directory{
+        std::unique_ptr<std::atomic<std::string*>[]> chunks;
+        size_t capacity;
+    };
+
+    // Make a directory with room for capacity chunks
+    static std::unique_ptr<Directory> makeDirectory(size_t capacity);
+
+    std::atomic<Directory*> directory; // Current directory, read without locking
+    std::vector<std::unique_ptr<Directory>> directories; // Current and retired directories
+    std::vector<std::unique_ptr<std::string[]>> chunks; // Owns the name chunks
+    std::atomic<std::uint32_t> count; // Number of names
+    std::unordered_map<std::string_view, ItemId> ids; // Views into the chunks
+    mutable std::shared_mutex mutex; // Guards ids and growth
+};
+
+#endif // ITEM_REGISTRY_H
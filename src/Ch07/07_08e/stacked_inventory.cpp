@@ -0,0 +1,186 @@
+#include "stacked_inventory.h"
+#include <limits>
+
+// Default Constructor
+StackedInventory::StackedInventory(): capacity(10), stackLimit(std::numeric_limits<int>::max()), stackCount(0), totalUnits(0), registry(&ItemRegistry::global()) {}
+
+// Overloaded Constructor, capacity is the number of stacks
+StackedInventory::StackedInventory(int capacity_i): capacity(capacity_i), stackLimit(std::numeric_limits<int>::max()), stackCount(0), totalUnits(0), registry(&ItemRegistry::global()) {}
+
+// Overloaded Constructor with a default limit of units per stack
+StackedInventory::StackedInventory(int capacity_i, int stackLimit_i): capacity(capacity_i), stackLimit(stackLimit_i), stackCount(0), totalUnits(0), registry(&ItemRegistry::global()) {}
+
+// Overloaded Constructor with a per-world registry
+StackedInventory::StackedInventory(int capacity_i, int stackLimit_i, ItemRegistry& registry_i): capacity(capacity_i), stackLimit(stackLimit_i), stackCount(0), totalUnits(0), registry(&registry_i) {}
+
+// Add one unit of an item
+StackedInventory& StackedInventory::operator+=(const std::string& item){
+    return *this += registry->intern(item);
+}
+
+StackedInventory& StackedInventory::operator+=(ItemId item){
+    if (addUnits(item, 1) == 0)
+        std::cout << "Inventory is full, cannot add " << registry->name(item) << std::endl;
+    return *this;
+}
+
+// Remove one unit of an item
+StackedInventory& StackedInventory::operator-=(const std::string& item){
+    std::optional<ItemId> id = registry->lookup(item);
+    if (!id || removeUnits(*id, 1) == 0)
+        std::cout << "Item " << item << " not found in inventory" << std::endl;
+    return *this;
+}
+
+StackedInventory& StackedInventory::operator-=(ItemId item){
+    if (removeUnits(item, 1) == 0)
+        std::cout << "Item " << registry->name(item) << " not found in inventory" << std::endl;
+    return *this;
+}
+
+// Add up to quantity units in O(1), opening new stacks while capacity allows; returns how many were added
+int StackedInventory::addUnits(const std::string& item, int quantity){
+    return addUnits(registry->intern(item), quantity);
+}
+
+int StackedInventory::addUnits(ItemId item, int quantity){
+    int limit = getStackLimit(item);
+    if (quantity <= 0 || limit <= 0) return 0;
+    auto it = entryIndex.find(item);
+    int held = it != entryIndex.end() ? entries[it->second].quantity : 0;
+    int used = stacksFor(held, limit);
+
+    // Room left in this item's stacks plus every free stack, in 64 bits so a large limit cannot overflow
+    long long room = static_cast<long long>(capacity - stackCount + used) * limit - held;
+    room = std::min<long long>(room, std::numeric_limits<int>::max() - held);
+    int added = static_cast<int>(std::min<long long>(quantity, room));
+    if (added <= 0) return 0; // Checked first, so a full inventory never leaves an empty entry behind
+    if (it == entryIndex.end()){
+        entries.push_back(Entry{item, 0});
+        it = entryIndex.emplace(item, entries.size() - 1).first;
+    }
+    entries[it->second].quantity += added;
+    stackCount += stacksFor(held + added, limit) - used;
+    totalUnits += added;
+    return added;
+}
+
+// Remove up to quantity units in O(1), returns how many were removed
+int StackedInventory::removeUnits(const std::string& item, int quantity){
+    std::optional<ItemId> id = registry->lookup(item);
+    return id ? removeUnits(*id, quantity) : 0;
+}
+
+int StackedInventory::removeUnits(ItemId item, int quantity){
+    if (quantity <= 0) return 0;
+    auto it = entryIndex.find(item);
+    if (it == entryIndex.end()) return 0;
+    size_t pos = it->second;
+    int limit = getStackLimit(item);
+    int held = entries[pos].quantity;
+    int removed = std::min(quantity, held);
+    entries[pos].quantity -= removed;
+    stackCount -= stacksFor(held, limit) - stacksFor(held - removed, limit);
+    totalUnits -= removed;
+
+    // An emptied item frees its slot: the last entry moves into it, so only one index entry changes
+    if (entries[pos].quantity == 0){
+        entryIndex.erase(it);
+        if (pos != entries.size() - 1){
+            entries[pos] = entries.back();
+            entryIndex[entries[pos].item] = pos;
+        }
+        entries.pop_back();
+    }
+    return removed;
+}
+
+// Get units held of one item
+int StackedInventory::getQuantity(const std::string& item) const{
+    std::optional<ItemId> id = registry->lookup(item);
+    return id ? getQuantity(*id) : 0;
+}
+
+int StackedInventory::getQuantity(ItemId item) const{
+    auto it = entryIndex.find(item);
+    return it != entryIndex.end() ? entries[it->second].quantity : 0;
+}
+
+// Override the stack limit for one item. Units already held are restacked, never dropped,
+// so a lower limit can leave more stacks than the capacity; adding then fails until units go.
+void StackedInventory::setStackLimit(const std::string& item, int limit){
+    setStackLimit(registry->intern(item), limit);
+}
+
+void StackedInventory::setStackLimit(ItemId item, int limit){
+    int held = getQuantity(item);
+    stackCount -= stacksFor(held, getStackLimit(item));
+    stackLimits[item] = limit;
+    stackCount += stacksFor(held, limit);
+}
+
+// Get the stack limit that applies to one item
+int StackedInventory::getStackLimit(ItemId item) const{
+    auto it = stackLimits.find(item);
+    return it != stackLimits.end() ? it->second : stackLimit;
+}
+
+// Number of stacks quantity units need at a limit (a limit below 1 counts as 1)
+int StackedInventory::stacksFor(int quantity, int limit){
+    if (quantity <= 0) return 0;
+    return 1 + (quantity - 1) / std::max(limit, 1);
+}
+
+// Access the item of a stack by index, O(number of items)
+const std::string& StackedInventory::operator[](int index) const{
+    static const std::string outOfBounds = "Index out of bounds";
+    for (const Entry& entry : entries){
+        if (index < 0) break;
+        int stacksOfItem = stacksFor(entry.quantity, getStackLimit(entry.item));
+        if (index < stacksOfItem)
+            return registry->name(entry.item);
+        index -= stacksOfItem;
+    }
+    return outOfBounds;
+}
+
+// Get total number of units in the inventory
+int StackedInventory::getItemCount() const{
+    return totalUnits;
+}
+
+// Get number of stacks in the inventory
+int StackedInventory::getStackCount() const{
+    return stackCount;
+}
+
+// Display inventory contents, one entry per stack
+void StackedInventory::displayInventory() const{
+    thread_local RenderBuffer buffer;
+    render(buffer, RenderFormat::TEXT);
+    buffer.flushTo(std::cout);
+}
+
+// Render inventory contents into a caller-owned buffer, one entry per stack, no output is written
+void StackedInventory::render(RenderBuffer& out, RenderFormat format, std::string_view label) const{
+    // Labels like "Potion x20" are rebuilt in place, so their strings keep their capacity between calls
+    thread_local std::vector<std::string> labels;
+    size_t count = 0;
+    forEachStack([&](ItemId item, int quantity){
+        if (count == labels.size()) labels.emplace_back();
+        std::string& text = labels[count++];
+        text = registry->name(item);
+        if (quantity > 1){
+            text += " x";
+            text += std::to_string(quantity);
+        }
+    });
+
+    struct Labels{
+        const std::string* first;
+        const std::string* last;
+        const std::string* begin() const { return first; }
+        const std::string* end() const { return last; }
+    };
+    renderInventory(Labels{labels.data(), labels.data() + count}, out, format, label);
+}
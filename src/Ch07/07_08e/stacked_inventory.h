@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef STACKED_INVENTORY_H
+#define STACKED_INVENTORY_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <string_view>
+#include <iostream>
+#include "item_registry.h"
+#include "inventory_render.h"
+
+// Inventory that stores counted stacks instead of one entry per unit.
+// An item holding more units than its stack limit spreads over several stacks, full ones
+// first, and every stack counts against the capacity. Only one count is kept per item:
+// its stacks are worked out from the count and the limit when they are needed.
+class StackedInventory{
+public:
+    // Constructor
+    StackedInventory();
+
+    // Overloaded Constructor, capacity is the number of stacks
+    StackedInventory(int capacity_i);
+
+    // Overloaded Constructor with a default limit of units per stack
+    StackedInventory(int capacity_i, int stackLimit_i);
+
+    // Overloaded Constructor with a per-world registry
+    StackedInventory(int capacity_i, int stackLimit_i, ItemRegistry& registry_i);
+
+    // Add one unit of an item
+    StackedInventory& operator+=(const std::string& item);
+    StackedInventory& operator+=(ItemId item);
+
+    // Remove one unit of an item
+    StackedInventory& operator-=(const std::string& item);
+    StackedInventory& operator-=(ItemId item);
+
+    // Add up to quantity units in O(1), opening new stacks while capacity allows; returns how many were added
+    int addUnits(const std::string& item, int quantity);
+    int addUnits(ItemId item, int quantity);
+
+    // Remove up to quantity units in O(1), returns how many were removed
+    int removeUnits(const std::string& item, int quantity);
+    int removeUnits(ItemId item, int quantity);
+
+    // Get units held of one item
+    int getQuantity(const std::string& item) const;
+    int getQuantity(ItemId item) const;
+
+    // Override the stack limit for one item. Units already held are restacked, never dropped,
+    // so a lower limit can leave more stacks than the capacity; adding then fails until units go.
+    void setStackLimit(const std::string& item, int limit);
+    void setStackLimit(ItemId item, int limit);
+
+    // Get the stack limit that applies to one item
+    int getStackLimit(ItemId item) const;
+
+    // Access the item of a stack by index, O(number of items)
+    const std::string& operator[](int index) const;
+
+    // Get total number of units in the inventory
+    int getItemCount() const;
+
+    // Get number of stacks in the inventory
+    int getStackCount() const;
+
+    // Display inventory contents, one entry per stack
+    void displayInventory() const;
+
+    // Render inventory contents into a caller-owned buffer, one entry per stack, no output is written
+    void render(RenderBuffer& out, RenderFormat format, std::string_view label = "Inventory") const;
+
+private:
+    // One item and how many units of it are held over all its stacks
+    struct Entry{
+        ItemId item;
+        int quantity;
+    };
+
+    // Number of stacks quantity units need at a limit (a limit below 1 counts as 1)
+    static int stacksFor(int quantity, int limit);
+
+    // Call visit(ItemId, quantity) for every stack, in stack order
+    template<typename Visitor>
+    void forEachStack(Visitor visit) const{
+        for (const Entry& entry : entries){
+            int limit = std::max(getStackLimit(entry.item), 1);
+            int left = entry.quantity;
+            for (; left > limit; left -= limit)
+                visit(entry.item, limit);
+            visit(entry.item, left);
+        }
+    }
+
+    std::vector<Entry> entries; // Items in fill order, until an emptied item is replaced by the last one
+    std::unordered_map<ItemId, size_t> entryIndex; // Item to position in entries
+    std::unordered_map<ItemId, int> stackLimits; // Per-item stack limit overrides
+    int capacity; // Maximum number of stacks allowed
+    int stackLimit; // Default maximum units per stack
+    int stackCount; // Stacks all entries take together
+    int totalUnits; // Sum of all quantities
+    ItemRegistry* registry; // Resolves ids to names, never null
+};
+
+#endif // STACKED_INVENTORY_H
@@ -0,0 +1,99 @@
+#include "trade.h"
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    const size_t LOCK_STRIPES = 64;
+
+    std::mutex stripes[LOCK_STRIPES];
+}
+
+// Constructor, throws std::invalid_argument if both sides are the same inventory
+Trade::Trade(Inventory& left_i, Inventory& right_i): left(left_i), right(right_i){
+    if (&left == &right)
+        throw std::invalid_argument("An inventory cannot trade with itself");
+}
+
+// Left gives an item to right
+Trade& Trade::give(std::string_view item){
+    leftToRight.push_back(Transfer{std::string(item), std::nullopt});
+    return *this;
+}
+
+// Right gives an item to left
+Trade& Trade::take(std::string_view item){
+    rightToLeft.push_back(Transfer{std::string(item), std::nullopt});
+    return *this;
+}
+
+// Validate and apply the whole trade
+TradeResult Trade::execute(){
+    std::mutex& leftLock = lockFor(left);
+    std::mutex& rightLock = lockFor(right);
+    std::unique_lock<std::mutex> first(leftLock, std::defer_lock);
+    std::unique_lock<std::mutex> second(rightLock, std::defer_lock);
+    if (&leftLock == &rightLock)
+        first.lock(); // Both inventories share a stripe
+    else
+        std::lock(first, second); // Deadlock-free whatever order other trades use
+
+    if (!holdsAll(left, leftToRight) || !holdsAll(right, rightToLeft))
+        return TradeResult::MISSING_ITEM;
+    int given = leftToRight.size();
+    int taken = rightToLeft.size();
+    if (left.getItemCount() - given + taken > left.getCapacity())
+        return TradeResult::LEFT_FULL;
+    if (right.getItemCount() - taken + given > right.getCapacity())
+        return TradeResult::RIGHT_FULL;
+
+    apply();
+    return TradeResult::COMPLETED;
+}
+
+// Lock guarding one inventory for trades
+std::mutex& Trade::lockFor(const Inventory& inventory){
+    return stripes[std::hash<const Inventory*>()(&inventory) % LOCK_STRIPES];
+}
+
+// Look every offered item up in the giver's registry and check the giver holds them all
+bool Trade::holdsAll(const Inventory& giver, std::vector<Transfer>& transfers){
+    std::unordered_map<ItemId, int> wanted;
+    for (Transfer& transfer : transfers){
+        transfer.from = giver.getRegistry().lookup(transfer.name);
+        if (!transfer.from) return false;
+        ++wanted[*transfer.from];
+    }
+    for (const auto& [item, count] : wanted)
+        if (giver.countOf(item) < count) return false;
+    return true;
+}
+
+// Intern the names on the receiving sides, then apply everything; throws only before the first change
+void Trade::apply(){
+    std::vector<ItemId> toRight;
+    std::vector<ItemId> toLeft;
+    toRight.reserve(leftToRight.size());
+    toLeft.reserve(rightToLeft.size());
+    for (const Transfer& transfer : leftToRight) toRight.push_back(right.getRegistry().intern(transfer.name));
+    for (const Transfer& transfer : rightToLeft) toLeft.push_back(left.getRegistry().intern(transfer.name));
+
+    // Every allocation happens here; each side journals its adds and its removals
+    size_t deltas = leftToRight.size() + rightToLeft.size();
+    right.prepareAppends(toRight.data(), toRight.size(), deltas);
+    try{
+        left.prepareAppends(toLeft.data(), toLeft.size(), deltas);
+    }
+    catch (...){
+        right.unprepareAppends(toRight.data(), toRight.size());
+        throw;
+    }
+
+    // Adds first, into the index entries just prepared, so a removal never frees an
+    // entry a later add would have to allocate again. Capacity was checked for the net
+    // change, and validation under both locks guarantees every removal finds its item
+    for (ItemId item : toRight) right.commitAppend(item);
+    for (ItemId item : toLeft) left.commitAppend(item);
+    for (const Transfer& transfer : leftToRight) left.removeId(*transfer.from);
+    for (const Transfer& transfer : rightToLeft) right.removeId(*transfer.from);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef TRADE_H
+#define TRADE_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include "inventory.h"
+
+// Outcome of Trade::execute
+enum class TradeResult{
+    COMPLETED,     // Both sides changed
+    MISSING_ITEM,  // A side does not hold everything it offers
+    LEFT_FULL,     // Left would end above its capacity
+    RIGHT_FULL     // Right would end above its capacity
+};
+
+// All-or-nothing exchange of items between two inventories.
+// execute() validates presence and capacity, then allocates everything both sides
+// will need before touching either, so applying cannot fail midway: a trade either
+// completes or throws with both inventories unchanged. Names are only interned into
+// the receiving registry once the trade is validated, so a rejected trade adds nothing. Trades lock both
+// inventories through a striped lock table, so concurrent trades that share an
+// inventory serialize; other threads writing to a traded inventory must hold lockFor() too.
+class Trade{
+public:
+    // Constructor, throws std::invalid_argument if both sides are the same inventory
+    Trade(Inventory& left_i, Inventory& right_i);
+
+    // Left gives an item to right
+    Trade& give(std::string_view item);
+
+    // Right gives an item to left
+    Trade& take(std::string_view item);
+
+    // Validate and apply the whole trade
+    TradeResult execute();
+
+    // Lock guarding one inventory for trades
+    static std::mutex& lockFor(const Inventory& inventory);
+
+private:
+    // One offered item, resolved in the giver's registry by execute()
+    struct Transfer{
+        std::string name;
+        std::optional<ItemId> from; // nullopt if the giver's registry has never seen the name
+    };
+
+    // Look every offered item up in the giver's registry and check the giver holds them all
+    static bool holdsAll(const Inventory& giver, std::vector<Transfer>& transfers);
+
+    // Intern the names on the receiving sides, then apply everything; throws only before the first change
+    void apply();
+
+    Inventory& left;
+    Inventory& right;
+    std::vector<Transfer> leftToRight;
+    std::vector<Transfer> rightToLeft;
+};
+
+#endif // TRADE_H
@@ -0,0 +1,64 @@
+// ============================================================================
+// FILE: bounds.h - Points and axis-aligned bounding boxes
+// ============================================================================
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <algorithm>
+#include <limits>
+
+// A position in the plane
+struct Point {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+// Axis-aligned box, edges included. The default box is empty: merging
+// anything into it gives that thing's box.
+struct Bounds {
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = std::numeric_limits<double>::infinity();
+    double maxX = -std::numeric_limits<double>::infinity();
+    double maxY = -std::numeric_limits<double>::infinity();
+    
+    bool empty() const { return minX > maxX || minY > maxY; }
+    
+    bool contains(const Point& p) const {
+        return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY;
+    }
+    
+    bool overlaps(const Bounds& other) const {
+        return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+    
+    // Grow to cover other
+    void merge(const Bounds& other) {
+        minX = std::min(minX, other.minX);
+        minY = std::min(minY, other.minY);
+        maxX = std::max(maxX, other.maxX);
+        maxY = std::max(maxY, other.maxY);
+    }
+    
+    void merge(const Point& p) {
+        minX = std::min(minX, p.x);
+        minY = std::min(minY, p.y);
+        maxX = std::max(maxX, p.x);
+        maxY = std::max(maxY, p.y);
+    }
+    
+    Point center() const { return Point{(minX + maxX) / 2, (minY + maxY) / 2}; }
+    
+    // Width plus height: in 2D the chance that a random query hits a box grows
+    // with its perimeter, so the surface area heuristic uses this (0 if empty)
+    double halfPerimeter() const { return empty() ? 0.0 : (maxX - minX) + (maxY - minY); }
+};
+
+inline bool operator==(const Bounds& a, const Bounds& b) {
+    return a.minX == b.minX && a.minY == b.minY && a.maxX == b.maxX && a.maxY == b.maxY;
+}
+
+inline bool operator!=(const Bounds& a, const Bounds& b) {
+    return !(a == b);
+}
+
+#endif // BOUNDS_H
@@ -0,0 +1,102 @@
+// ============================================================================
+// FILE: cached_shape.h - Opt-in caching of derived geometry
+// ============================================================================
+#ifndef CACHED_SHAPE_H
+#define CACHED_SHAPE_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include "SlabPool.h"
+#include "Circle.h"
+#include "Rectangle.h"
+
+// Wraps a concrete shape so getArea/getPerimeter are computed on first use and
+// then served from the object. setRadius/setDimensions reach invalidateCache()
+// through Shape::geometryChanged(), so the cache is dropped even when the
+// shape is changed through a Circle& or Rectangle&.
+//
+// Reads are thread-safe, so cached shapes can go through the parallel
+// reductions in GeometryUtils: threads that miss together each compute the
+// same value and store it. Changing a shape while other threads read it is
+// a race, as it is for the plain shapes.
+template<typename S>
+class Cached : public S {
+public:
+    using S::S;  // Same constructors as the wrapped shape
+    
+    // Atomics are not copyable, so copies take the current values explicitly
+    Cached(const Cached& other)
+        : S(other),
+          area(other.area.load(std::memory_order_relaxed)),
+          perimeter(other.perimeter.load(std::memory_order_relaxed)),
+          valid(other.valid.load(std::memory_order_acquire)) {}
+    
+    Cached& operator=(const Cached& other) {
+        S::operator=(other);
+        area.store(other.area.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        perimeter.store(other.perimeter.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        valid.store(other.valid.load(std::memory_order_acquire), std::memory_order_release);
+        return *this;
+    }
+    
+    double getArea() const override {
+        if (valid.load(std::memory_order_acquire) & AREA) {
+            return area.load(std::memory_order_relaxed);
+        }
+        double value = S::getArea();
+        area.store(value, std::memory_order_relaxed);
+        valid.fetch_or(AREA, std::memory_order_release);  // Publishes the store above
+        return value;
+    }
+    
+    double getPerimeter() const override {
+        if (valid.load(std::memory_order_acquire) & PERIMETER) {
+            return perimeter.load(std::memory_order_relaxed);
+        }
+        double value = S::getPerimeter();
+        perimeter.store(value, std::memory_order_relaxed);
+        valid.fetch_or(PERIMETER, std::memory_order_release);
+        return value;
+    }
+    
+    // Cached objects are bigger than S, so they get a slab pool of their own
+    static void* operator new(size_t size) {
+        if (size != sizeof(Cached)) {
+            return ::operator new(size);
+        }
+        return pool().allocate();
+    }
+    
+    static void operator delete(void* p, size_t size) {
+        if (size != sizeof(Cached)) {
+            ::operator delete(p);
+            return;
+        }
+        pool().deallocate(p);
+    }
+    
+    static SlabPool& pool() {
+        static SlabPool* cachedShapes = new SlabPool(sizeof(Cached), alignof(Cached));  // Never destroyed
+        return *cachedShapes;
+    }
+    
+protected:
+    void invalidateCache() override {
+        valid.store(0, std::memory_order_release);
+        S::invalidateCache();
+    }
+    
+private:
+    static constexpr unsigned char AREA = 1;
+    static constexpr unsigned char PERIMETER = 2;
+    
+    mutable std::atomic<double> area{0.0};
+    mutable std::atomic<double> perimeter{0.0};
+    mutable std::atomic<unsigned char> valid{0};  // Which of the values above are current
+};
+
+using CachedCircle = Cached<Circle>;
+using CachedRectangle = Cached<Rectangle>;
+
+#endif // CACHED_SHAPE_H
@@ -2,6 +2,8 @@
 // FILE: circle.cc - Circle implementation
 // ============================================================================
 #include "Circle.h"
+#include "SlabPool.h"
+#include <new>
 #include <stdexcept>
 
 // Default constructor
@@ -18,26 +20,58 @@ Circle::Circle(double r) : radius(r) {
 
 // Implement pure virtual functions
 double Circle::getArea() const {
-    return PI * radius * radius;
+    return calculateArea(radius);
 }
 
 double Circle::getPerimeter() const {
-    return 2 * PI * radius;
+    return calculatePerimeter(radius);
 }
 
 std::string Circle::getName() const {
     return "Circle";
 }
 
+Bounds Circle::getBounds(const Point& center) const {
+    return Bounds{center.x - radius, center.y - radius, center.x + radius, center.y + radius};
+}
+
+bool Circle::containsPoint(const Point& center, const Point& p) const {
+    double dx = p.x - center.x;
+    double dy = p.y - center.y;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
 // Circle-specific method
 void Circle::setRadius(double r) {
     if (r <= 0) {
         throw std::invalid_argument("Radius must be positive");
     }
     radius = r;
+    geometryChanged();
 }
 
 // Friend function definition
 bool operator==(const Circle& c1, const Circle& c2) {
     return c1.radius == c2.radius;
 }
+
+// Pooled allocation; a derived class of another size falls back to the heap
+void* Circle::operator new(size_t size) {
+    if (size != sizeof(Circle)) {
+        return ::operator new(size);
+    }
+    return pool().allocate();
+}
+
+void Circle::operator delete(void* p, size_t size) {
+    if (size != sizeof(Circle)) {
+        ::operator delete(p);
+        return;
+    }
+    pool().deallocate(p);
+}
+
+SlabPool& Circle::pool() {
+    static SlabPool* circles = new SlabPool(sizeof(Circle), alignof(Circle));  // Never destroyed: shapes may outlive statics
+    return *circles;
+}
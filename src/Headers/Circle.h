@@ -5,9 +5,11 @@
 #define CIRCLE_H
 
 #include "Shape.h"  // Need full definition because we're inheriting
+#include <cstddef>
 
-// Forward declaration example (not needed here, but showing the concept)
-class Point;  // If we only used Point*, we could forward declare
+// Forward declaration example: SlabPool is only returned by reference, so
+// its full definition can stay out of this header
+class SlabPool;
 
 class Circle : public Shape {
 private:
@@ -27,6 +29,12 @@ public:
     double getArea() const override;
     double getPerimeter() const override;
     std::string getName() const override;
+    ShapeKind getKind() const override { return KIND; }
+    Bounds getBounds(const Point& center) const override;
+    bool containsPoint(const Point& center, const Point& p) const override;
+    
+    // Compile-time tag, for code that knows it holds a Circle
+    static constexpr ShapeKind KIND = ShapeKind::CIRCLE;
     
     // Circle-specific methods
     void setRadius(double r);
@@ -34,9 +42,19 @@ public:
     
     // Static method - can be called without an object
     static double calculateArea(double radius);
+    static double calculatePerimeter(double radius);
     
     // Friend function declaration (defined elsewhere)
     friend bool operator==(const Circle& c1, const Circle& c2);
+    
+    // Class-specific allocation: new Circle (and make_unique) take a block from
+    // a slab pool, so circles sit next to each other and skip malloc.
+    // Do not mix with ::new Circle, which bypasses the pool.
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
+    
+    // Pool behind operator new, e.g. to turn thread caching off
+    static SlabPool& pool();
 };
 
 // Inline function definition (must be in header if used across files)
@@ -44,4 +62,8 @@ inline double Circle::calculateArea(double radius) {
     return PI * radius * radius;
 }
 
+inline double Circle::calculatePerimeter(double radius) {
+    return 2 * PI * radius;
+}
+
 #endif // CIRCLE_H
\ No newline at end of file
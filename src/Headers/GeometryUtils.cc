@@ -3,6 +3,10 @@
 // ============================================================================
 #include "GeometryUtils.h"
 #include "Shape.h"  // Now we need the full definition
+#include "ShapeStore.h"
+#include "Circle.h"
+#include "Rectangle.h"
+#include "ShapeKernels.h"
 
 namespace GeometryUtils {
     
@@ -32,4 +36,281 @@ const Shape* largestPerimeter(const std::vector<std::unique_ptr<Shape>>& shapes)
     return largest;
 }
 
+KindTable groupByKind(const std::vector<std::unique_ptr<Shape>>& shapes) {
+    KindTable table{};
+    for (const auto& shape : shapes) {
+        if (shape) {
+            table[kindIndex(shape->getKind())].add(shape->getArea(), shape->getPerimeter());
+        }
+    }
+    return table;
+}
+
+KindTable groupByKind(const ShapeStore& store) {
+    KindTable table{};
+    KindStats& circles = table[kindIndex(ShapeKind::CIRCLE)];
+    for (double r : store.getRadii()) {
+        circles.add(Circle::calculateArea(r), Circle::calculatePerimeter(r));
+    }
+    
+    const std::vector<double>& widths = store.getWidths();
+    const std::vector<double>& heights = store.getHeights();
+    for (size_t i = 0; i < widths.size(); ++i) {
+        double w = widths[i];
+        double h = heights[i];
+        ShapeKind kind = w == h ? ShapeKind::SQUARE : ShapeKind::RECTANGLE;  // Same test as Rectangle::isSquare
+        table[kindIndex(kind)].add(Rectangle::calculateArea(w, h), Rectangle::calculatePerimeter(w, h));
+    }
+    return table;
+}
+
+void ShapeSummary::merge(const ShapeSummary& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    size_t combined = count + other.count;
+    double delta = other.areaMean - areaMean;
+    areaMean += delta * other.count / combined;
+    areaM2 += other.areaM2 + delta * delta * (static_cast<double>(count) * other.count / combined);
+    count = combined;
+    totalArea += other.totalArea;
+    minArea = std::min(minArea, other.minArea);
+    maxArea = std::max(maxArea, other.maxArea);
+    totalPerimeter += other.totalPerimeter;
+    maxPerimeter = std::max(maxPerimeter, other.maxPerimeter);
+    for (size_t i = 0; i < SHAPE_KIND_COUNT; ++i) kindCounts[i] += other.kindCounts[i];
+    for (size_t i = 0; i < AREA_BINS; ++i) areaHistogram[i] += other.areaHistogram[i];
+}
+
+namespace {
+void summarizeRange(const std::vector<std::unique_ptr<Shape>>& shapes, size_t first, size_t last, ShapeSummary& summary) {
+    for (size_t i = first; i < last; ++i) {
+        if (shapes[i]) {
+            summary.add(shapes[i]->getKind(), shapes[i]->getArea(), shapes[i]->getPerimeter());
+        }
+    }
+}
+
+void summarizeCircles(const double* radii, size_t count, ShapeSummary& summary) {
+    for (size_t i = 0; i < count; ++i) {
+        summary.add(ShapeKind::CIRCLE, Circle::calculateArea(radii[i]), Circle::calculatePerimeter(radii[i]));
+    }
+}
+
+void summarizeRectangles(const double* widths, const double* heights, size_t count, ShapeSummary& summary) {
+    for (size_t i = 0; i < count; ++i) {
+        double w = widths[i];
+        double h = heights[i];
+        summary.add(w == h ? ShapeKind::SQUARE : ShapeKind::RECTANGLE,
+                    Rectangle::calculateArea(w, h), Rectangle::calculatePerimeter(w, h));
+    }
+}
+}
+
+ShapeSummary summarize(const std::vector<std::unique_ptr<Shape>>& shapes) {
+    ShapeSummary summary;
+    summarizeRange(shapes, 0, shapes.size(), summary);
+    return summary;
+}
+
+ShapeSummary summarize(const ShapeStore& store) {
+    ShapeSummary summary;
+    summarizeCircles(store.getRadii().data(), store.circleCount(), summary);
+    summarizeRectangles(store.getWidths().data(), store.getHeights().data(), store.rectangleCount(), summary);
+    return summary;
+}
+
+AggregateCache::AggregateCache(const std::vector<std::unique_ptr<Shape>>& shapes_i) : shapes(shapes_i) {}
+
+double AggregateCache::totalArea() {
+    if (isStale()) refresh();
+    return total;
+}
+
+const Shape* AggregateCache::largestPerimeter() {
+    if (isStale()) refresh();
+    return largest;
+}
+
+// Versions only grow, so the sum moves whenever one of them does
+std::uint64_t AggregateCache::currentVersionSum() const {
+    std::uint64_t sum = 0;
+    for (const auto& shape : shapes) {
+        if (shape) sum += shape->getGeometryVersion();
+    }
+    return sum;
+}
+
+bool AggregateCache::isStale() const {
+    return !valid || size != shapes.size() || versionSum != currentVersionSum();
+}
+
+void AggregateCache::invalidate() {
+    valid = false;
+}
+
+void AggregateCache::refresh() {
+    versionSum = currentVersionSum();
+    size = shapes.size();
+    total = 0.0;
+    largest = nullptr;
+    double maxPerimeter = 0.0;
+    for (const auto& shape : shapes) {
+        if (!shape) continue;
+        total += shape->getArea();
+        double perimeter = shape->getPerimeter();
+        if (perimeter > maxPerimeter) {
+            maxPerimeter = perimeter;
+            largest = shape.get();
+        }
+    }
+    valid = true;
+}
+
+double totalArea(const ShapeStore& store) {
+    return store.totalArea();
+}
+
+double largestPerimeter(const ShapeStore& store) {
+    return store.largestPerimeter();
+}
+
+ShapeSummary parallelSummarize(const std::vector<std::unique_ptr<Shape>>& shapes, ThreadPool& pool) {
+    size_t chunks = (shapes.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    std::vector<ShapeSummary> partials(chunks);
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t first = chunk * PARALLEL_CHUNK;
+        summarizeRange(shapes, first, std::min(first + PARALLEL_CHUNK, shapes.size()), partials[chunk]);
+    });
+    
+    ShapeSummary summary;
+    for (const ShapeSummary& partial : partials) {
+        summary.merge(partial);
+    }
+    return summary;
+}
+
+ShapeSummary parallelSummarize(const ShapeStore& store, ThreadPool& pool) {
+    // Circle chunks first, then rectangle chunks, like parallelTotalArea
+    size_t circleChunks = (store.circleCount() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    size_t rectangleChunks = (store.rectangleCount() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    std::vector<ShapeSummary> partials(circleChunks + rectangleChunks);
+    pool.parallelFor(partials.size(), [&](size_t chunk) {
+        if (chunk < circleChunks) {
+            size_t first = chunk * PARALLEL_CHUNK;
+            summarizeCircles(store.getRadii().data() + first,
+                             std::min(PARALLEL_CHUNK, store.circleCount() - first), partials[chunk]);
+        } else {
+            size_t first = (chunk - circleChunks) * PARALLEL_CHUNK;
+            summarizeRectangles(store.getWidths().data() + first, store.getHeights().data() + first,
+                                std::min(PARALLEL_CHUNK, store.rectangleCount() - first), partials[chunk]);
+        }
+    });
+    
+    ShapeSummary summary;
+    for (const ShapeSummary& partial : partials) {
+        summary.merge(partial);
+    }
+    return summary;
+}
+
+double combinePartials(const std::vector<double>& partials) {
+    return ShapeKernels::sum(partials.data(), partials.size());
+}
+
+double parallelTotalArea(const std::vector<std::unique_ptr<Shape>>& shapes, ThreadPool& pool) {
+    size_t chunks = (shapes.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    std::vector<double> partials(chunks);
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t first = chunk * PARALLEL_CHUNK;
+        size_t last = std::min(first + PARALLEL_CHUNK, shapes.size());
+        double total = 0.0;
+        for (size_t i = first; i < last; ++i) {
+            if (shapes[i]) {
+                total += shapes[i]->getArea();
+            }
+        }
+        partials[chunk] = total;
+    });
+    return combinePartials(partials);
+}
+
+const Shape* parallelLargestPerimeter(const std::vector<std::unique_ptr<Shape>>& shapes, ThreadPool& pool) {
+    // Each chunk keeps its first largest shape, then chunks are scanned in order
+    // with the same strict comparison, so ties resolve exactly like the serial loop
+    size_t chunks = (shapes.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    std::vector<const Shape*> winners(chunks, nullptr);
+    std::vector<double> perimeters(chunks, 0.0);
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t first = chunk * PARALLEL_CHUNK;
+        size_t last = std::min(first + PARALLEL_CHUNK, shapes.size());
+        for (size_t i = first; i < last; ++i) {
+            if (shapes[i] && shapes[i]->getPerimeter() > perimeters[chunk]) {
+                perimeters[chunk] = shapes[i]->getPerimeter();
+                winners[chunk] = shapes[i].get();
+            }
+        }
+    });
+    
+    const Shape* largest = nullptr;
+    double maxPerimeter = 0.0;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        if (winners[chunk] && perimeters[chunk] > maxPerimeter) {
+            maxPerimeter = perimeters[chunk];
+            largest = winners[chunk];
+        }
+    }
+    return largest;
+}
+
+double parallelTotalArea(const ShapeStore& store, ThreadPool& pool) {
+    // Circle chunks first, then rectangle chunks, each summed by the SIMD kernels
+    const double* r = store.getRadii().data();
+    const double* w = store.getWidths().data();
+    const double* h = store.getHeights().data();
+    size_t circleChunks = (store.circleCount() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    size_t rectangleChunks = (store.rectangleCount() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    std::vector<double> partials(circleChunks + rectangleChunks);
+    pool.parallelFor(partials.size(), [&](size_t chunk) {
+        if (chunk < circleChunks) {
+            size_t first = chunk * PARALLEL_CHUNK;
+            size_t count = std::min(PARALLEL_CHUNK, store.circleCount() - first);
+            partials[chunk] = ShapeKernels::sumCircleAreas(r + first, count);
+        } else {
+            size_t first = (chunk - circleChunks) * PARALLEL_CHUNK;
+            size_t count = std::min(PARALLEL_CHUNK, store.rectangleCount() - first);
+            partials[chunk] = ShapeKernels::sumRectangleAreas(w + first, h + first, count);
+        }
+    });
+    return combinePartials(partials);
+}
+
+double parallelLargestPerimeter(const ShapeStore& store, ThreadPool& pool) {
+    // A maximum is exact, so any split gives the same answer
+    const std::vector<double>& r = store.getRadii();
+    const std::vector<double>& w = store.getWidths();
+    const std::vector<double>& h = store.getHeights();
+    size_t circleChunks = (r.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    size_t rectangleChunks = (w.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    std::vector<double> partials(circleChunks + rectangleChunks, 0.0);
+    pool.parallelFor(partials.size(), [&](size_t chunk) {
+        double largest = 0.0;
+        if (chunk < circleChunks) {
+            size_t first = chunk * PARALLEL_CHUNK;
+            size_t last = std::min(first + PARALLEL_CHUNK, r.size());
+            largest = Circle::calculatePerimeter(*std::max_element(r.begin() + first, r.begin() + last));
+        } else {
+            size_t first = (chunk - circleChunks) * PARALLEL_CHUNK;
+            size_t last = std::min(first + PARALLEL_CHUNK, w.size());
+            for (size_t i = first; i < last; ++i) {
+                largest = std::max(largest, Rectangle::calculatePerimeter(w[i], h[i]));
+            }
+        }
+        partials[chunk] = largest;
+    });
+    return partials.empty() ? 0.0 : *std::max_element(partials.begin(), partials.end());
+}
+
 } // namespace GeometryUtils
\ No newline at end of file
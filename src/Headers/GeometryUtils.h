@@ -6,9 +6,17 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "ThreadPool.h"  // Full definition needed for the default pool argument
+#include "ShapeKind.h"
 
 // Forward declaration is enough here
 class Shape;
+class ShapeStore;
 
 namespace GeometryUtils {
     // Calculate total area of multiple shapes
@@ -17,6 +25,131 @@ namespace GeometryUtils {
     // Find shape with largest perimeter
     const Shape* largestPerimeter(const std::vector<std::unique_ptr<Shape>>& shapes);
     
+    // Same questions for a data-oriented store, answered from its columns
+    double totalArea(const ShapeStore& store);
+    double largestPerimeter(const ShapeStore& store);
+    
+    // Totals for one kind of shape
+    struct KindStats {
+        size_t count = 0;
+        double totalArea = 0.0;
+        double totalPerimeter = 0.0;
+        double maxArea = 0.0;
+        double maxPerimeter = 0.0;
+        
+        void add(double area, double perimeter) {
+            ++count;
+            totalArea += area;
+            totalPerimeter += perimeter;
+            maxArea = std::max(maxArea, area);
+            maxPerimeter = std::max(maxPerimeter, perimeter);
+        }
+    };
+    
+    // One KindStats per ShapeKind, indexed with kindIndex()
+    using KindTable = std::array<KindStats, SHAPE_KIND_COUNT>;
+    
+    // Count, sum and find maxima per kind in one pass. Shapes are grouped by
+    // getKind(), so no name string is ever built.
+    KindTable groupByKind(const std::vector<std::unique_ptr<Shape>>& shapes);
+    KindTable groupByKind(const ShapeStore& store);
+    
+    // Everything the separate utilities answer, gathered in one pass.
+    // Area mean and variance use Welford's update, so they stay accurate for
+    // large collections, and two summaries of disjoint parts can be merged.
+    struct ShapeSummary {
+        // Areas fall into power-of-two bins: bin i holds [2^(i-8), 2^(i-7)),
+        // the first and last bins also take everything below and above.
+        // Fixed edges are what lets summaries merge.
+        static constexpr size_t AREA_BINS = 32;
+        static constexpr int AREA_BIN_OFFSET = 8;
+        
+        size_t count = 0;
+        double totalArea = 0.0;
+        double minArea = 0.0;  // 0 while empty
+        double maxArea = 0.0;
+        double totalPerimeter = 0.0;
+        double maxPerimeter = 0.0;
+        double areaMean = 0.0;  // Running mean (Welford)
+        double areaM2 = 0.0;    // Sum of squared deviations from the running mean
+        std::array<size_t, SHAPE_KIND_COUNT> kindCounts{};  // Indexed with kindIndex()
+        std::array<size_t, AREA_BINS> areaHistogram{};
+        
+        double meanArea() const { return count == 0 ? 0.0 : totalArea / count; }
+        double areaVariance() const { return count == 0 ? 0.0 : areaM2 / count; }  // Population variance
+        size_t squareCount() const { return kindCounts[kindIndex(ShapeKind::SQUARE)]; }
+        
+        static size_t areaBin(double area) {
+            if (!(area >= 1.0 / 256)) return 0;  // Also catches zero and NaN
+            if (!std::isfinite(area)) return AREA_BINS - 1;  // ilogb(inf) is INT_MAX
+            return std::min(static_cast<size_t>(std::ilogb(area) + AREA_BIN_OFFSET), AREA_BINS - 1);
+        }
+        
+        void add(ShapeKind kind, double area, double perimeter) {
+            minArea = count == 0 ? area : std::min(minArea, area);
+            maxArea = std::max(maxArea, area);
+            ++count;
+            totalArea += area;
+            totalPerimeter += perimeter;
+            maxPerimeter = std::max(maxPerimeter, perimeter);
+            double delta = area - areaMean;
+            areaMean += delta / count;
+            areaM2 += delta * (area - areaMean);
+            ++kindCounts[kindIndex(kind)];
+            ++areaHistogram[areaBin(area)];
+        }
+        
+        // Fold in a summary of other shapes (Chan et al. for the variance).
+        // Merging the same partials in the same order always gives the same result.
+        void merge(const ShapeSummary& other);
+    };
+    
+    // One pass over the collection for all of ShapeSummary
+    ShapeSummary summarize(const std::vector<std::unique_ptr<Shape>>& shapes);
+    ShapeSummary summarize(const ShapeStore& store);  // Circles first, then rectangles
+    
+    // Remembers totalArea and largestPerimeter of one collection and only
+    // recomputes them once one of its shapes changed (Shape::getGeometryVersion)
+    // or the collection changed size. Call invalidate() after replacing elements.
+    //
+    // Checking costs one version read per shape, with no virtual call and no
+    // geometry, so a query stays O(n) but much cheaper than a recompute.
+    // Changes to shapes outside this collection never make it stale.
+    class AggregateCache {
+    public:
+        explicit AggregateCache(const std::vector<std::unique_ptr<Shape>>& shapes_i);
+        
+        double totalArea();
+        const Shape* largestPerimeter();
+        
+        // True if the next query will walk the collection
+        bool isStale() const;
+        
+        // Force the next query to walk the collection
+        void invalidate();
+        
+    private:
+        // Compute both aggregates in one pass
+        void refresh();
+        
+        std::uint64_t currentVersionSum() const;
+        
+        const std::vector<std::unique_ptr<Shape>>& shapes;
+        std::uint64_t versionSum = 0;  // Sum of the shapes' geometry versions the values were computed at
+        size_t size = 0;               // Collection size they were computed for
+        bool valid = false;
+        double total = 0.0;
+        const Shape* largest = nullptr;
+    };
+    
+    // Area of one element of any pointer-like type. A ShapeVariant
+    // (ShapeVariant.h) picks its own getArea overload by argument-dependent
+    // lookup instead, so the templates below never make a virtual call for it.
+    template<typename P>
+    double getArea(const P& shape) {
+        return shape->getArea();
+    }
+    
     // Template function must be defined in header
     template<typename T>
     double averageArea(const std::vector<T>& shapes) {
@@ -24,10 +157,45 @@ namespace GeometryUtils {
         
         double sum = 0.0;
         for (const auto& shape : shapes) {
-            sum += shape->getArea();
+            sum += getArea(shape);
         }
         return sum / shapes.size();
     }
+    
+    // Parallel versions. Shapes are split into chunks of PARALLEL_CHUNK (a few
+    // L1 caches worth of pointers or doubles) and the per-chunk results are
+    // combined in chunk order, so the answer never depends on the thread count.
+    constexpr size_t PARALLEL_CHUNK = 4096;
+    
+    double parallelTotalArea(const std::vector<std::unique_ptr<Shape>>& shapes, ThreadPool& pool = ThreadPool::shared());
+    const Shape* parallelLargestPerimeter(const std::vector<std::unique_ptr<Shape>>& shapes, ThreadPool& pool = ThreadPool::shared());
+    double parallelTotalArea(const ShapeStore& store, ThreadPool& pool = ThreadPool::shared());
+    double parallelLargestPerimeter(const ShapeStore& store, ThreadPool& pool = ThreadPool::shared());
+    
+    // Chunks are summarized in parallel and merged in chunk order
+    ShapeSummary parallelSummarize(const std::vector<std::unique_ptr<Shape>>& shapes, ThreadPool& pool = ThreadPool::shared());
+    ShapeSummary parallelSummarize(const ShapeStore& store, ThreadPool& pool = ThreadPool::shared());
+    
+    // Compensated sum of per-chunk results, in chunk order
+    double combinePartials(const std::vector<double>& partials);
+    
+    template<typename T>
+    double parallelAverageArea(const std::vector<T>& shapes, ThreadPool& pool = ThreadPool::shared()) {
+        if (shapes.empty()) return 0.0;
+        
+        size_t chunks = (shapes.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+        std::vector<double> partials(chunks);
+        pool.parallelFor(chunks, [&](size_t chunk) {
+            size_t first = chunk * PARALLEL_CHUNK;
+            size_t last = std::min(first + PARALLEL_CHUNK, shapes.size());
+            double sum = 0.0;
+            for (size_t i = first; i < last; ++i) {
+                sum += getArea(shapes[i]);
+            }
+            partials[chunk] = sum;
+        });
+        return combinePartials(partials) / shapes.size();
+    }
 }
 
 #endif // GEOMETRY_UTILS_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+// ============================================================================
+// FILE: mapped_file.cc
+// ============================================================================
+#include "MappedFile.h"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef MAPPED_FILE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* pages = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pages == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        ::madvise(pages, length, MADV_SEQUENTIAL);  // Readers stream through the file
+        base = static_cast<const char*>(pages);
+        mapped = true;
+    }
+    ::close(fd);  // The mapping stays valid without the descriptor
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    base = contents.data();
+    length = contents.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef MAPPED_FILE_MMAP
+    if (mapped) {
+        ::munmap(const_cast<char*>(base), length);
+    }
+#endif
+}
@@ -0,0 +1,34 @@
+// ============================================================================
+// FILE: mapped_file.h - Read-only view of a whole file
+// ============================================================================
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Maps the file into memory on POSIX systems, so pages are read on demand and
+// nothing is copied; elsewhere the file is read into a string once.
+class MappedFile {
+public:
+    // Throws std::runtime_error if the file cannot be opened or mapped
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    
+    // Owns the mapping, so no copies
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(base, length); }
+    
+private:
+    const char* base = "";  // Never null, so empty files still give a valid view
+    size_t length = 0;
+    bool mapped = false;
+    std::string contents;   // Fallback storage when mapping is not available
+};
+
+#endif // MAPPED_FILE_H
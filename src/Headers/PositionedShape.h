@@ -0,0 +1,26 @@
+// ============================================================================
+// FILE: positioned_shape.h - A shape placed in the plane
+// ============================================================================
+#ifndef POSITIONED_SHAPE_H
+#define POSITIONED_SHAPE_H
+
+#include <memory>
+#include <utility>
+#include "Shape.h"  // Calls through the pointer, so the full definition is needed
+#include "Bounds.h"
+
+// Owns a shape and the point its centre sits on. Spatial indexes (ShapeBvh,
+// ShapeGrid) refer to these by their index in a std::vector.
+struct PositionedShape {
+    std::unique_ptr<Shape> shape;
+    Point position;
+    
+    PositionedShape() = default;
+    PositionedShape(std::unique_ptr<Shape> shape_i, const Point& position_i)
+        : shape(std::move(shape_i)), position(position_i) {}
+    
+    Bounds getBounds() const { return shape->getBounds(position); }
+    bool contains(const Point& p) const { return shape->containsPoint(position, p); }
+};
+
+#endif // POSITIONED_SHAPE_H
@@ -2,6 +2,8 @@
 // FILE: rectangle.cc
 // ============================================================================
 #include "Rectangle.h"
+#include "SlabPool.h"
+#include <new>
 #include <stdexcept>
 
 Rectangle::Rectangle(double w, double h) : width(w), height(h) {
@@ -11,21 +13,52 @@ Rectangle::Rectangle(double w, double h) : width(w), height(h) {
 }
 
 double Rectangle::getArea() const {
-    return width * height;
+    return calculateArea(width, height);
 }
 
 double Rectangle::getPerimeter() const {
-    return 2 * (width + height);
+    return calculatePerimeter(width, height);
 }
 
 std::string Rectangle::getName() const {
     return isSquare() ? "Square" : "Rectangle";
 }
 
+// Axis-aligned, centred on center
+Bounds Rectangle::getBounds(const Point& center) const {
+    return Bounds{center.x - width / 2, center.y - height / 2, center.x + width / 2, center.y + height / 2};
+}
+
+bool Rectangle::containsPoint(const Point& center, const Point& p) const {
+    return getBounds(center).contains(p);
+}
+
 void Rectangle::setDimensions(double w, double h) {
     if (w <= 0 || h <= 0) {
         throw std::invalid_argument("Dimensions must be positive");
     }
     width = w;
     height = h;
+    geometryChanged();
+}
+
+// Pooled allocation; a derived class of another size falls back to the heap
+void* Rectangle::operator new(size_t size) {
+    if (size != sizeof(Rectangle)) {
+        return ::operator new(size);
+    }
+    return pool().allocate();
+}
+
+void Rectangle::operator delete(void* p, size_t size) {
+    if (size != sizeof(Rectangle)) {
+        ::operator delete(p);
+        return;
+    }
+    pool().deallocate(p);
+}
+
+SlabPool& Rectangle::pool() {
+    static SlabPool* rectangles = new SlabPool(sizeof(Rectangle), alignof(Rectangle));  // Never destroyed
+    return *rectangles;
 }
@@ -5,6 +5,9 @@
 #define RECTANGLE_H
 
 #include "Shape.h"
+#include <cstddef>
+
+class SlabPool;  // Only returned by reference
 
 class Rectangle : public Shape {
 private:
@@ -18,6 +21,12 @@ public:
     double getArea() const override;
     double getPerimeter() const override;
     std::string getName() const override;
+    ShapeKind getKind() const override { return isSquare() ? ShapeKind::SQUARE : KIND; }
+    Bounds getBounds(const Point& center) const override;
+    bool containsPoint(const Point& center, const Point& p) const override;
+    
+    // Compile-time tag; a Rectangle object reports SQUARE at runtime when its sides match
+    static constexpr ShapeKind KIND = ShapeKind::RECTANGLE;
     
     // Rectangle-specific
     void setDimensions(double w, double h);
@@ -26,6 +35,25 @@ public:
     
     // Special type: Square is a Rectangle
     bool isSquare() const { return width == height; }
+    
+    // Static methods - same formulas, usable without an object
+    static double calculateArea(double w, double h);
+    static double calculatePerimeter(double w, double h);
+    
+    // Class-specific allocation from a slab pool, same rules as Circle
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
+    static SlabPool& pool();
 };
 
+// Inline so callers that know they hold a Rectangle can skip the virtual call.
+// The one copy of each formula: getArea/getPerimeter and ShapeStore use these too.
+inline double Rectangle::calculateArea(double w, double h) {
+    return w * h;
+}
+
+inline double Rectangle::calculatePerimeter(double w, double h) {
+    return 2 * (w + h);
+}
+
 #endif // RECTANGLE_H
\ No newline at end of file
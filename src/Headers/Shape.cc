@@ -8,4 +8,20 @@ void Shape::printInfo() const {
     std::cout << "Shape: " << getName() 
               << " | Area: " << getArea() 
               << " | Perimeter: " << getPerimeter() << std::endl;
-}
\ No newline at end of file
+}
+
+Bounds Shape::getBounds(const Point& center) const {
+    // No point of a closed outline is further than half its length from a point inside it
+    double reach = getPerimeter() / 2;
+    return Bounds{center.x - reach, center.y - reach, center.x + reach, center.y + reach};
+}
+
+bool Shape::containsPoint(const Point& center, const Point& p) const {
+    // Without the outline, the box is the only test that never rejects a real hit
+    return getBounds(center).contains(p);
+}
+
+void Shape::geometryChanged() {
+    invalidateCache();
+    ++geometryVersion;
+}
@@ -5,6 +5,10 @@
 #define SHAPE_H
 
 #include <string>
+#include <cstdint>
+#include <string_view>
+#include "ShapeKind.h"
+#include "Bounds.h"
 
 // Abstract base class (interface in C++ terms)
 class Shape {
@@ -14,11 +18,45 @@ public:
     virtual double getPerimeter() const = 0;
     virtual std::string getName() const = 0;
     
+    // Same answer as getName(), without building a string. Shapes outside this
+    // library need not override it; they are grouped together as OTHER.
+    virtual ShapeKind getKind() const { return ShapeKind::OTHER; }
+    
+    // Shapes carry no position of their own; a placed shape (PositionedShape.h)
+    // passes its centre in. Circle and Rectangle give tight axis-aligned bounds.
+    // The defaults only know area and perimeter: the box reaches perimeter / 2
+    // from the centre, which covers any shape drawn around it, and a point is
+    // taken to be inside if it falls in that box. The default containsPoint is
+    // only approximate: it never misses a point of the shape but also accepts
+    // points around it. Override both for exact spatial queries.
+    virtual Bounds getBounds(const Point& center) const;
+    virtual bool containsPoint(const Point& center, const Point& p) const;
+    
+    // Name of the kind from static storage, never allocates ("Shape" for OTHER).
+    // For grouping and telemetry; a subclass's own getName() may differ.
+    std::string_view getKindName() const { return kindName(getKind()); }
+    
     // Virtual destructor is crucial for proper cleanup in polymorphic hierarchies
     virtual ~Shape() = default;
     
     // Non-virtual function that uses the virtual ones
     void printInfo() const;  // Declaration only - definition in shape.cc
+    
+    // Bumped every time this shape changes its dimensions. Caches and indexes
+    // over a collection remember the versions they saw, so a change only makes
+    // the collections holding this shape stale. Plain data, like the
+    // dimensions: changing a shape while other threads read it is a race.
+    std::uint64_t getGeometryVersion() const { return geometryVersion; }
+    
+protected:
+    // Derived setters call this after changing a dimension
+    void geometryChanged();
+    
+    // Hook for shapes that cache derived values (see CachedShape.h)
+    virtual void invalidateCache() {}
+    
+private:
+    std::uint64_t geometryVersion = 0;
 };
 
 #endif // SHAPE_H
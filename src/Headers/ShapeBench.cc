@@ -0,0 +1,631 @@
+// ============================================================================
+// FILE: shape_bench.cc - Timing the shape representations against each other
+// ============================================================================
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Shape.h"
+#include "Circle.h"
+#include "Rectangle.h"
+#include "ShapeStore.h"
+#include "GeometryUtils.h"
+#include "ShapeKernels.h"
+#include "ThreadPool.h"
+#include "ShapeVariant.h"
+#include "ShapeFactory.h"
+#include "SlabPool.h"
+#include "CachedShape.h"
+#include "PositionedShape.h"
+#include "ShapeBvh.h"
+#include "ShapeGrid.h"
+#include "ShapeFile.h"
+
+namespace {
+
+// Best of several runs in milliseconds, the result is kept so the work is not optimized away
+template<typename Kernel>
+double timeKernel(Kernel kernel, double& result) {
+    double best = 1e300;
+    for (int run = 0; run < 5; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        result = kernel();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+    return best;
+}
+
+void report(const std::string& name, double ms, double result, double baseline) {
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2) << ms << " ms"
+              << std::setw(9) << std::setprecision(1) << baseline / ms << "x"
+              << "   result " << std::setprecision(6) << std::scientific << result
+              << std::defaultfloat << std::endl;
+}
+
+// Nanoseconds per shape, repeating small collections so each timing covers ~8M shapes
+template<typename Kernel>
+double nsPerShape(Kernel kernel, size_t count, double& result) {
+    size_t repeats = std::max<size_t>(1, 8000000 / count);
+    double ms = timeKernel([&] {
+        double sum = 0;
+        for (size_t rep = 0; rep < repeats; ++rep) sum += kernel();
+        return sum;
+    }, result);
+    return ms * 1e6 / (static_cast<double>(repeats) * count);
+}
+
+// Virtual dispatch through unique_ptr<Shape> against std::visit over ShapeVariant
+void benchmarkVariant() {
+    std::cout << "\n--- unique_ptr<Shape> vs ShapeVariant (ns per shape) ---" << std::endl;
+    std::cout << std::left << std::setw(10) << "shapes" << std::setw(16) << "mix"
+              << std::right << std::setw(12) << "ptr total" << std::setw(12) << "var total"
+              << std::setw(12) << "ptr avg" << std::setw(12) << "var avg" << std::endl;
+    
+    struct Mix { const char* name; double circleShare; };
+    for (size_t count : {1000, 65536, 1000000}) {
+        for (Mix mix : {Mix{"circles only", 1.0}, Mix{"90% circles", 0.9}, Mix{"50/50", 0.5}}) {
+            std::mt19937_64 rng(count);
+            std::uniform_real_distribution<double> dimension(0.5, 10.0);
+            std::bernoulli_distribution isCircle(mix.circleShare);
+            std::vector<std::unique_ptr<Shape>> pointers;
+            std::vector<ShapeVariant> variants;
+            pointers.reserve(count);
+            variants.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                double a = dimension(rng), b = dimension(rng);
+                if (isCircle(rng)) {
+                    pointers.push_back(std::make_unique<Circle>(a));
+                    variants.emplace_back(Circle(a));
+                } else {
+                    pointers.push_back(std::make_unique<Rectangle>(a, b));
+                    variants.emplace_back(Rectangle(a, b));
+                }
+            }
+            
+            double r1, r2, r3, r4;
+            double ptrTotal = nsPerShape([&] { return GeometryUtils::totalArea(pointers); }, count, r1);
+            double varTotal = nsPerShape([&] { return GeometryUtils::totalArea(variants); }, count, r2);
+            double ptrAvg = nsPerShape([&] { return GeometryUtils::averageArea(pointers); }, count, r3);
+            double varAvg = nsPerShape([&] { return GeometryUtils::averageArea(variants); }, count, r4);
+            std::cout << std::left << std::setw(10) << count << std::setw(16) << mix.name
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << ptrTotal << std::setw(12) << varTotal
+                      << std::setw(12) << ptrAvg << std::setw(12) << varAvg
+                      << (r1 == r2 && r3 == r4 ? "" : "  RESULTS DIFFER") << std::defaultfloat << std::endl;
+        }
+    }
+}
+
+// Single timed run in milliseconds, for work that must not be repeated on the same store
+template<typename Work>
+double timeOnce(Work work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// Per-line createFromDescription against the bulk importer on the same text
+bool benchmarkImport(size_t count) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> dimension(0.5, 10.0);
+    std::string text;
+    char line[96];
+    for (size_t i = 0; i < count; ++i) {
+        int length = i % 2 == 0
+            ? std::snprintf(line, sizeof line, "circle %.6f\n", dimension(rng))
+            : std::snprintf(line, sizeof line, "rectangle %.6f %.6f\n", dimension(rng), dimension(rng));
+        text.append(line, length);
+    }
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "shape_bench_import.txt";
+    std::ofstream(path, std::ios::binary).write(text.data(), text.size());
+    
+    std::cout << "\n--- import " << count << " descriptions (" << text.size() / (1 << 20) << " MiB) ---" << std::endl;
+    auto row = [](const std::string& name, double ms, double baseline) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed
+                  << std::setprecision(2) << ms << " ms" << std::setw(9) << std::setprecision(1)
+                  << baseline / ms << "x" << std::defaultfloat << std::endl;
+    };
+    
+    std::vector<std::unique_ptr<Shape>> objects;
+    double baseline = timeOnce([&] {
+        size_t begin = 0;
+        while (begin < text.size()) {
+            size_t end = text.find('\n', begin);
+            objects.push_back(ShapeFactory::createFromDescription(text.substr(begin, end - begin)));
+            begin = end + 1;
+        }
+    });
+    row("createFromDescription per line", baseline, baseline);
+    
+    ShapeStore perLine;
+    row("createFromDescription(store) per line", timeOnce([&] {
+        size_t begin = 0;
+        while (begin < text.size()) {
+            size_t end = text.find('\n', begin);
+            ShapeFactory::createFromDescription(perLine, text.substr(begin, end - begin));
+            begin = end + 1;
+        }
+    }), baseline);
+    
+    ThreadPool single(1);
+    ShapeStore bulkSingle, bulkShared, bulkFile;
+    row("createFromDescriptions, 1 thread", timeOnce([&] {
+        ShapeFactory::createFromDescriptions(bulkSingle, text, single);
+    }), baseline);
+    row("createFromDescriptions, " + std::to_string(ThreadPool::shared().size()) + " thread(s)", timeOnce([&] {
+        ShapeFactory::createFromDescriptions(bulkShared, text);
+    }), baseline);
+    row("createFromDescriptionFile (mmap)", timeOnce([&] {
+        ShapeFactory::createFromDescriptionFile(bulkFile, path.string());
+    }), baseline);
+    std::filesystem::remove(path);
+    
+    // Same shapes through the columnar binary format. The file was just
+    // written, so it is in the page cache: this measures everything but the disk.
+    std::filesystem::path binary = std::filesystem::temp_directory_path() / "shape_bench_import.bin";
+    row("ShapeFile::write", timeOnce([&] { ShapeFile::write(binary.string(), perLine); }), baseline);
+    ShapeStore binaryChecked, binaryUnchecked;
+    row("ShapeFile load, checksums verified", timeOnce([&] {
+        ShapeFile(binary.string(), true).loadInto(binaryChecked);
+    }), baseline);
+    row("ShapeFile load, unverified", timeOnce([&] {
+        ShapeFile(binary.string()).loadInto(binaryUnchecked);
+    }), baseline);
+    double inPlace = 0;
+    row("ShapeFile open + totalArea in place", timeOnce([&] {
+        ShapeFile file(binary.string());
+        inPlace = file.view().totalArea();
+    }), baseline);
+    std::filesystem::remove(binary);
+    
+    auto same = [&](const ShapeStore& a) {
+        return a.getRadii() == perLine.getRadii() && a.getWidths() == perLine.getWidths()
+            && a.getHeights() == perLine.getHeights();
+    };
+    bool identical = same(bulkSingle) && same(bulkShared) && same(bulkFile) && objects.size() == perLine.size()
+                     && same(binaryChecked) && same(binaryUnchecked) && inPlace == perLine.totalArea();
+    std::cout << "Imported shapes identical: " << (identical ? "yes" : "NO") << std::endl;
+    return identical;
+}
+
+// Baseline for the pools: the same objects placed with the global allocator
+struct HeapDelete {
+    void operator()(Shape* shape) const {
+        shape->~Shape();
+        ::operator delete(shape);
+    }
+};
+using HeapShape = std::unique_ptr<Shape, HeapDelete>;
+
+template<typename T, typename... Args>
+HeapShape makeHeapShape(Args... args) {
+    void* block = ::operator new(sizeof(T));
+    return HeapShape(::new (block) T(args...));
+}
+
+// Allocation cost and traversal locality of the slab pools against malloc
+void benchmarkPools(size_t count) {
+    std::cout << "\n--- slab pools vs global heap, " << count << " shapes ---" << std::endl;
+    auto row = [](const std::string& name, double ms, size_t operations) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed
+                  << std::setprecision(2) << ms << " ms" << std::setw(10) << ms * 1e6 / operations
+                  << " ns/op" << std::defaultfloat << std::endl;
+    };
+    
+    // Create and destroy every shape, interleaving the two types
+    auto churnPooled = [&] {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        shapes.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 2 == 0) shapes.push_back(std::make_unique<Circle>(1.0 + i % 7));
+            else shapes.push_back(std::make_unique<Rectangle>(1.0 + i % 5, 2.0));
+        }
+    };
+    auto churnHeap = [&] {
+        std::vector<HeapShape> shapes;
+        shapes.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 2 == 0) shapes.push_back(makeHeapShape<Circle>(1.0 + i % 7));
+            else shapes.push_back(makeHeapShape<Rectangle>(1.0 + i % 5, 2.0));
+        }
+    };
+    churnPooled();  // Warm both allocators so neither pays for first-touch pages
+    churnHeap();
+    row("create+destroy, global heap", timeOnce(churnHeap), 2 * count);
+    row("create+destroy, slab pool", timeOnce(churnPooled), 2 * count);
+    Circle::pool().setThreadCaching(false);
+    Rectangle::pool().setThreadCaching(false);
+    row("create+destroy, slab pool, no thread cache", timeOnce(churnPooled), 2 * count);
+    Circle::pool().setThreadCaching(true);
+    Rectangle::pool().setThreadCaching(true);
+    
+    // A level that has lived a while: a random half of the shapes removed
+    // (order kept) and replaced by new ones appended at the end
+    auto age = [&](auto& shapes, auto makeCircle, auto makeRectangle) {
+        std::mt19937_64 rng(3);
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 2 == 0) shapes.push_back(makeCircle(1.0 + i % 7));
+            else shapes.push_back(makeRectangle(1.0 + i % 5, 2.0));
+        }
+        std::bernoulli_distribution removed(0.5);
+        for (auto& shape : shapes) {
+            if (removed(rng)) shape.reset();
+        }
+        shapes.erase(std::remove(shapes.begin(), shapes.end(), nullptr), shapes.end());
+        for (size_t i = 0; i < count / 2; ++i) {
+            if (i % 2 == 0) shapes.push_back(makeCircle(1.0 + i % 7));
+            else shapes.push_back(makeRectangle(1.0 + i % 5, 2.0));
+        }
+    };
+    std::vector<HeapShape> heapShapes;
+    std::vector<std::unique_ptr<Shape>> pooledShapes;
+    age(heapShapes, [](double r) { return makeHeapShape<Circle>(r); },
+        [](double w, double h) { return makeHeapShape<Rectangle>(w, h); });
+    age(pooledShapes, [](double r) { return std::unique_ptr<Shape>(std::make_unique<Circle>(r)); },
+        [](double w, double h) { return std::unique_ptr<Shape>(std::make_unique<Rectangle>(w, h)); });
+    
+    double result = 0;
+    row("averageArea after churn, global heap",
+        timeKernel([&] { return GeometryUtils::averageArea(heapShapes); }, result), count);
+    row("averageArea after churn, slab pool",
+        timeKernel([&] { return GeometryUtils::averageArea(pooledShapes); }, result), count);
+    std::cout << "Slabs: " << Circle::pool().getSlabCount() << " circle, "
+              << Rectangle::pool().getSlabCount() << " rectangle" << std::endl;
+}
+
+// Repeated aggregate queries with occasional setRadius calls, at several read/write ratios
+bool benchmarkCaching(size_t count) {
+    std::cout << "\n--- cached geometry, " << count << " shapes (us per operation) ---" << std::endl;
+    std::cout << std::left << std::setw(18) << "reads:writes" << std::right << std::setw(14) << "plain"
+              << std::setw(16) << "cached shapes" << std::setw(18) << "+ AggregateCache" << std::endl;
+    
+    auto build = [&](bool cached) {
+        bool previous = ShapeFactory::isGeometryCaching();
+        ShapeFactory::setGeometryCaching(cached);
+        std::vector<std::unique_ptr<Shape>> shapes;
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 2 == 0) shapes.push_back(ShapeFactory::createShape(ShapeFactory::ShapeType::CIRCLE, 1.0 + i % 7));
+            else shapes.push_back(ShapeFactory::createShape(ShapeFactory::ShapeType::RECTANGLE, 1.0 + i % 5, 2.0));
+        }
+        ShapeFactory::setGeometryCaching(previous);
+        return shapes;
+    };
+    // Every run replays the same operation sequence, so the answers must agree
+    bool agree = true;
+    struct Ratio { const char* name; int reads; int writes; };
+    for (Ratio ratio : {Ratio{"1000:1", 1000, 1}, Ratio{"100:1", 100, 1}, Ratio{"10:1", 10, 1},
+                        Ratio{"1:1", 1, 1}, Ratio{"1:10", 1, 10}}) {
+        const int operations = 2000;
+        auto run = [&](bool cachedShapes, bool aggregate, double& checksum) {
+            std::vector<std::unique_ptr<Shape>> shapes = build(cachedShapes);
+            std::mt19937_64 rng(11);
+            GeometryUtils::AggregateCache cache(shapes);
+            checksum = 0;
+            return timeOnce([&] {
+                for (int op = 0; op < operations; ++op) {
+                    if (op % (ratio.reads + ratio.writes) < ratio.reads) {
+                        if (aggregate) {
+                            checksum += cache.totalArea() + cache.largestPerimeter()->getPerimeter();
+                        } else {
+                            checksum += GeometryUtils::totalArea(shapes)
+                                      + GeometryUtils::largestPerimeter(shapes)->getPerimeter();
+                        }
+                    } else {
+                        size_t index = rng() % (shapes.size() / 2) * 2;  // Even rows hold circles
+                        static_cast<Circle&>(*shapes[index]).setRadius(1.0 + rng() % 7);
+                    }
+                }
+            }) * 1000 / operations;
+        };
+        
+        double plainSum, cachedSum, aggregateSum;
+        double plainUs = run(false, false, plainSum);
+        double cachedUs = run(true, false, cachedSum);
+        double aggregateUs = run(true, true, aggregateSum);
+        agree = agree && plainSum == cachedSum && cachedSum == aggregateSum;
+        std::cout << std::left << std::setw(18) << ratio.name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << plainUs << std::setw(16) << cachedUs << std::setw(18) << aggregateUs
+                  << std::defaultfloat << std::endl;
+    }
+    std::cout << "Cached results match plain: " << (agree ? "yes" : "NO") << std::endl;
+    return agree;
+}
+
+// Region and point queries on a scene of constant density: linear scan, BVH, grid
+bool benchmarkSpatial(size_t count) {
+    std::cout << "\n--- spatial queries, " << count << " positioned shapes ---" << std::endl;
+    auto row = [](const std::string& name, double ms, size_t operations) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed
+                  << std::setprecision(2) << ms << " ms" << std::setw(12) << ms * 1e6 / operations
+                  << " ns/op" << std::defaultfloat << std::endl;
+    };
+    
+    // About one shape per 100 square units, shapes up to 5 units across
+    std::mt19937_64 rng(5);
+    double side = 10.0 * std::sqrt(static_cast<double>(count));
+    std::uniform_real_distribution<double> position(0.0, side);
+    std::uniform_real_distribution<double> dimension(0.5, 5.0);
+    std::vector<PositionedShape> scene;
+    scene.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Point at{position(rng), position(rng)};
+        if (i % 2 == 0) scene.emplace_back(std::make_unique<Circle>(dimension(rng) / 2), at);
+        else scene.emplace_back(std::make_unique<Rectangle>(dimension(rng), dimension(rng)), at);
+    }
+    
+    std::unique_ptr<ShapeBvh> bvh;
+    std::unique_ptr<ShapeGrid> grid;
+    row("build BVH", timeOnce([&] { bvh = std::make_unique<ShapeBvh>(scene); }), count);
+    row("build grid (cell 5)", timeOnce([&] { grid = std::make_unique<ShapeGrid>(scene, 5.0); }), count);
+    
+    const size_t queries = 2000;
+    std::vector<Bounds> regions;
+    std::vector<Point> points;
+    for (size_t q = 0; q < queries; ++q) {
+        Point corner{position(rng), position(rng)};
+        regions.push_back(Bounds{corner.x, corner.y, corner.x + 20, corner.y + 20});
+        points.push_back(Point{position(rng), position(rng)});
+    }
+    
+    // Every method must find the same number of shapes
+    std::vector<size_t> found;
+    size_t scanHits = 0, bvhHits = 0, gridHits = 0;
+    size_t scanQueries = std::min<size_t>(queries, std::max<size_t>(1, 20000000 / std::max<size_t>(count, 1)));
+    double ms = timeOnce([&] {
+        for (size_t q = 0; q < scanQueries; ++q) {
+            for (const PositionedShape& shape : scene) {
+                if (shape.getBounds().overlaps(regions[q])) ++scanHits;
+            }
+        }
+    });
+    row("region 20x20, linear scan", ms, scanQueries);
+    ms = timeOnce([&] {
+        for (size_t q = 0; q < queries; ++q) {
+            found.clear();
+            bvhHits += bvh->findInRegion(regions[q], found);
+        }
+    });
+    row("region 20x20, BVH", ms, queries);
+    ms = timeOnce([&] {
+        for (size_t q = 0; q < queries; ++q) {
+            found.clear();
+            gridHits += grid->findInRegion(regions[q], found);
+        }
+    });
+    row("region 20x20, grid", ms, queries);
+    size_t bvhCheck = 0, gridCheck = 0;
+    for (size_t q = 0; q < scanQueries; ++q) {
+        found.clear();
+        bvhCheck += bvh->findInRegion(regions[q], found);
+        found.clear();
+        gridCheck += grid->findInRegion(regions[q], found);
+    }
+    bool agree = scanHits == bvhCheck && scanHits == gridCheck && bvhHits == gridHits;
+    
+    size_t bvhPoints = 0, gridPoints = 0;
+    ms = timeOnce([&] {
+        for (const Point& p : points) {
+            found.clear();
+            bvhPoints += bvh->findAtPoint(p, found);
+        }
+    });
+    row("point, BVH", ms, queries);
+    ms = timeOnce([&] {
+        for (const Point& p : points) {
+            found.clear();
+            gridPoints += grid->findAtPoint(p, found);
+        }
+    });
+    row("point, grid", ms, queries);
+    agree = agree && bvhPoints == gridPoints;
+    
+    // Resize 1% of the shapes, then bring both indexes up to date
+    size_t resized = std::max<size_t>(1, count / 100);
+    std::vector<size_t> changed;
+    for (size_t i = 0; i < resized; ++i) {
+        size_t index = rng() % (count / 2 + 1) * 2 % count;  // Even rows hold circles
+        static_cast<Circle&>(*scene[index].shape).setRadius(dimension(rng) / 2);
+        changed.push_back(index);
+    }
+    ShapeBvh rebuilt(scene);
+    row("BVH update() each resized shape", timeOnce([&] { for (size_t i : changed) bvh->update(i); }), resized);
+    row("BVH refit()", timeOnce([&] { bvh->refit(); }), count);
+    row("BVH build()", timeOnce([&] { rebuilt.build(); }), count);
+    row("grid update() each resized shape", timeOnce([&] { for (size_t i : changed) grid->update(i); }), resized);
+    
+    size_t afterBvh = 0, afterRebuilt = 0, afterGrid = 0;
+    for (const Bounds& region : regions) {
+        found.clear();
+        afterBvh += bvh->findInRegion(region, found);
+        found.clear();
+        afterRebuilt += rebuilt.findInRegion(region, found);
+        found.clear();
+        afterGrid += grid->findInRegion(region, found);
+    }
+    agree = agree && afterBvh == afterRebuilt && afterBvh == afterGrid;
+    std::cout << "Spatial indexes agree with a linear scan: " << (agree ? "yes" : "NO") << std::endl;
+    return agree;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    // Same random shapes in both representations, half circles and half rectangles
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dimension(0.5, 10.0);
+    std::vector<std::unique_ptr<Shape>> shapes;
+    ShapeStore store;
+    shapes.reserve(count);
+    store.reserve(count / 2 + 1, count / 2 + 1);
+    for (size_t i = 0; i < count; ++i) {
+        double a = dimension(rng), b = dimension(rng);
+        if (i % 2 == 0) {
+            shapes.push_back(std::make_unique<Circle>(a));
+            store.addCircle(a);
+        } else {
+            shapes.push_back(std::make_unique<Rectangle>(a, b));
+            store.addRectangle(a, b);
+        }
+    }
+
+    // Long-lived programs rarely visit objects in allocation order
+    std::vector<std::unique_ptr<Shape>> shuffled;
+    shuffled.reserve(count);
+    for (const auto& shape : shapes) {
+        if (const auto* circle = dynamic_cast<const Circle*>(shape.get())) {
+            shuffled.push_back(std::make_unique<Circle>(*circle));
+        } else {
+            shuffled.push_back(std::make_unique<Rectangle>(static_cast<const Rectangle&>(*shape)));
+        }
+    }
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    std::cout << "Shapes: " << count << std::endl;
+    std::cout << "\n--- totalArea ---" << std::endl;
+    double result = 0;
+    double baseline = timeKernel([&] { return GeometryUtils::totalArea(shapes); }, result);
+    report("unique_ptr<Shape>, allocation order", baseline, result, baseline);
+    const double serialArea = baseline;
+    double ms = timeKernel([&] { return GeometryUtils::totalArea(shuffled); }, result);
+    report("unique_ptr<Shape>, shuffled", ms, result, baseline);
+    ms = timeKernel([&] { return GeometryUtils::totalArea(store); }, result);
+    report("ShapeStore columns", ms, result, baseline);
+
+    std::cout << "\n--- totalArea by kernel ISA ---" << std::endl;
+    const ShapeKernels::Isa dispatched = ShapeKernels::activeIsa();
+    for (ShapeKernels::Isa isa : {ShapeKernels::Isa::SCALAR, ShapeKernels::Isa::SSE2,
+                                  ShapeKernels::Isa::AVX2, ShapeKernels::Isa::AVX512}) {
+        if (!ShapeKernels::useIsa(isa)) continue;
+        std::string name = std::string("ShapeStore, ") + ShapeKernels::isaName(isa);
+        if (isa == dispatched) name += " (dispatched)";
+        ms = timeKernel([&] { return store.totalArea(); }, result);
+        report(name, ms, result, baseline);
+    }
+    ShapeKernels::useIsa(dispatched);
+
+    std::cout << "\n--- largestPerimeter ---" << std::endl;
+    baseline = timeKernel([&] { return GeometryUtils::largestPerimeter(shapes)->getPerimeter(); }, result);
+    report("unique_ptr<Shape>, allocation order", baseline, result, baseline);
+    ms = timeKernel([&] { return GeometryUtils::largestPerimeter(shuffled)->getPerimeter(); }, result);
+    report("unique_ptr<Shape>, shuffled", ms, result, baseline);
+    ms = timeKernel([&] { return GeometryUtils::largestPerimeter(store); }, result);
+    report("ShapeStore columns", ms, result, baseline);
+
+    // Results must be bit-identical whatever the thread count
+    std::cout << "\n--- parallel reductions (hardware threads: "
+              << std::thread::hardware_concurrency() << ") ---" << std::endl;
+    bool deterministic = true;
+    double firstShapes = 0, firstStore = 0, firstAverage = 0;
+    const Shape* firstLargest = nullptr;
+    for (size_t threads : {1, 2, 4, 8}) {
+        ThreadPool pool(threads);
+        std::string suffix = ", " + std::to_string(threads) + " thread" + (threads > 1 ? "s" : "");
+        double shapesTotal = 0, storeTotal = 0, average = 0, ignored = 0;
+        const Shape* largest = nullptr;
+        ms = timeKernel([&] { return shapesTotal = GeometryUtils::parallelTotalArea(shapes, pool); }, result);
+        report("parallelTotalArea unique_ptr" + suffix, ms, result, serialArea);
+        ms = timeKernel([&] { return storeTotal = GeometryUtils::parallelTotalArea(store, pool); }, result);
+        report("parallelTotalArea ShapeStore" + suffix, ms, result, serialArea);
+        timeKernel([&] { return average = GeometryUtils::parallelAverageArea(shapes, pool); }, ignored);
+        timeKernel([&] { largest = GeometryUtils::parallelLargestPerimeter(shapes, pool); return 0.0; }, ignored);
+        if (threads == 1) {
+            firstShapes = shapesTotal;
+            firstStore = storeTotal;
+            firstAverage = average;
+            firstLargest = largest;
+        }
+        deterministic = deterministic && shapesTotal == firstShapes && storeTotal == firstStore
+                        && average == firstAverage && largest == firstLargest;
+    }
+    deterministic = deterministic && firstLargest == GeometryUtils::largestPerimeter(shapes);
+    std::cout << "Results identical across thread counts: " << (deterministic ? "yes" : "NO") << std::endl;
+
+    // Per-kind telemetry: keyed by getName() as callers used to, against groupByKind
+    std::cout << "\n--- per-kind totals ---" << std::endl;
+    auto tableTotal = [](const GeometryUtils::KindTable& table) {
+        double sum = 0;
+        for (const GeometryUtils::KindStats& stats : table) sum += stats.totalArea + stats.maxPerimeter;
+        return sum;
+    };
+    double byName = 0;
+    baseline = timeKernel([&] {
+        std::map<std::string, GeometryUtils::KindStats> groups;
+        for (const auto& shape : shapes) groups[shape->getName()].add(shape->getArea(), shape->getPerimeter());
+        byName = 0;
+        for (const auto& group : groups) byName += group.second.totalArea + group.second.maxPerimeter;
+        return byName;
+    }, result);
+    report("map keyed by getName()", baseline, result, baseline);
+    double byKind = 0;
+    ms = timeKernel([&] { return byKind = tableTotal(GeometryUtils::groupByKind(shapes)); }, result);
+    report("groupByKind unique_ptr<Shape>", ms, result, baseline);
+    ms = timeKernel([&] { return tableTotal(GeometryUtils::groupByKind(store)); }, result);
+    report("groupByKind ShapeStore", ms, result, baseline);
+    bool grouped = byName == byKind;
+    std::cout << "Grouping by kind matches grouping by name: " << (grouped ? "yes" : "NO") << std::endl;
+
+    // Four separate passes, as callers used to write it, against one fused pass
+    std::cout << "\n--- summary statistics ---" << std::endl;
+    baseline = timeKernel([&] {
+        double total = GeometryUtils::totalArea(shapes);
+        double perimeter = GeometryUtils::largestPerimeter(shapes)->getPerimeter();
+        double average = GeometryUtils::averageArea(shapes);
+        size_t squares = 0;
+        for (const auto& shape : shapes) {
+            const auto* rectangle = dynamic_cast<const Rectangle*>(shape.get());
+            if (rectangle && rectangle->isSquare()) ++squares;
+        }
+        return total + perimeter + average + squares;
+    }, result);
+    report("separate passes unique_ptr<Shape>", baseline, result, baseline);
+    GeometryUtils::ShapeSummary summary;
+    ms = timeKernel([&] {
+        summary = GeometryUtils::summarize(shapes);
+        return summary.totalArea + summary.maxPerimeter + summary.meanArea() + summary.squareCount();
+    }, result);
+    report("summarize unique_ptr<Shape>", ms, result, baseline);
+    ms = timeKernel([&] {
+        GeometryUtils::ShapeSummary columns = GeometryUtils::summarize(store);
+        return columns.totalArea + columns.maxPerimeter + columns.meanArea() + columns.squareCount();
+    }, result);
+    report("summarize ShapeStore", ms, result, baseline);
+    bool summarized = summary.count == shapes.size()
+                      && summary.totalArea == GeometryUtils::totalArea(shapes)
+                      && summary.maxPerimeter == GeometryUtils::largestPerimeter(shapes)->getPerimeter()
+                      && summary.maxPerimeter == GeometryUtils::summarize(store).maxPerimeter;
+    for (size_t threads : {1, 2, 4}) {
+        ThreadPool pool(threads);
+        GeometryUtils::ShapeSummary one = GeometryUtils::parallelSummarize(shapes, pool);
+        GeometryUtils::ShapeSummary reference = GeometryUtils::parallelSummarize(shapes, ThreadPool::shared());
+        summarized = summarized && one.totalArea == reference.totalArea && one.areaM2 == reference.areaM2
+                     && one.areaHistogram == reference.areaHistogram && one.count == summary.count;
+    }
+    std::cout << "Area mean " << summary.meanArea() << ", standard deviation " << std::sqrt(summary.areaVariance())
+              << ", squares " << summary.squareCount() << std::endl;
+    std::cout << "Summary matches the separate passes: " << (summarized ? "yes" : "NO") << std::endl;
+
+    benchmarkVariant();
+    bool imported = benchmarkImport(count);
+    benchmarkPools(count);
+    bool cachesAgree = benchmarkCaching(std::min<size_t>(count, 100000));
+    bool spatialAgree = benchmarkSpatial(count);
+
+    return deterministic && grouped && summarized && imported && cachesAgree && spatialAgree ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+// ============================================================================
+// FILE: shape_bvh.cc
+// ============================================================================
+#include "ShapeBvh.h"
+#include "PositionedShape.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+// Past this depth nodes split at the median, which bounds the tree depth (and
+// the traversal stack) even for pathological scenes
+constexpr size_t SAH_MAX_DEPTH = 32;
+constexpr size_t STACK_SIZE = 80;
+
+double centerOn(const Bounds& b, bool alongX) {
+    return alongX ? (b.minX + b.maxX) / 2 : (b.minY + b.maxY) / 2;
+}
+}
+
+ShapeBvh::ShapeBvh(const std::vector<PositionedShape>& shapes_i) : shapes(shapes_i) {
+    build();
+}
+
+void ShapeBvh::build() {
+    if (shapes.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Too many shapes for ShapeBvh");
+    }
+    size_t count = shapes.size();
+    shapeBounds.resize(count);
+    versions.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        versions[i] = shapes[i].shape->getGeometryVersion();
+        shapeBounds[i] = shapes[i].getBounds();
+    }
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0u);
+    leafOf.assign(count, 0);
+    nodes.clear();
+    if (count == 0) return;
+    
+    nodes.reserve(2 * (count / MAX_LEAF + 1));
+    buildNode(0, static_cast<std::uint32_t>(count), 0, 0);
+}
+
+std::uint32_t ShapeBvh::buildNode(std::uint32_t first, std::uint32_t last, std::uint32_t parent, size_t depth) {
+    // nodes may reallocate while children are built, so work through the index
+    std::uint32_t index = static_cast<std::uint32_t>(nodes.size());
+    nodes.emplace_back();
+    nodes[index].parent = parent;
+    
+    Bounds bounds;
+    Bounds centroids;
+    for (std::uint32_t i = first; i < last; ++i) {
+        bounds.merge(shapeBounds[order[i]]);
+        centroids.merge(shapeBounds[order[i]].center());
+    }
+    nodes[index].bounds = bounds;
+    
+    std::uint32_t count = last - first;
+    if (count <= MAX_LEAF) {
+        nodes[index].first = first;
+        nodes[index].count = count;
+        for (std::uint32_t i = first; i < last; ++i) {
+            leafOf[order[i]] = index;
+        }
+        return index;
+    }
+    
+    // Split along the axis where the centroids spread most
+    bool alongX = centroids.maxX - centroids.minX >= centroids.maxY - centroids.minY;
+    double low = alongX ? centroids.minX : centroids.minY;
+    double extent = alongX ? centroids.maxX - low : centroids.maxY - low;
+    auto binOf = [&](std::uint32_t shape) {
+        size_t bin = static_cast<size_t>((centerOn(shapeBounds[shape], alongX) - low) / extent * SAH_BINS);
+        return std::min(bin, SAH_BINS - 1);
+    };
+    
+    std::uint32_t mid = first + count / 2;
+    bool split = false;
+    if (depth < SAH_MAX_DEPTH && extent > 0) {
+        // Cost of a split = shapes on each side times the half perimeter of
+        // their box; sweep the bins from both ends to price every plane
+        size_t binCounts[SAH_BINS] = {};
+        Bounds binBounds[SAH_BINS];
+        for (std::uint32_t i = first; i < last; ++i) {
+            size_t bin = binOf(order[i]);
+            ++binCounts[bin];
+            binBounds[bin].merge(shapeBounds[order[i]]);
+        }
+        double rightCost[SAH_BINS] = {};
+        Bounds side;
+        size_t sideCount = 0;
+        for (size_t bin = SAH_BINS - 1; bin > 0; --bin) {
+            side.merge(binBounds[bin]);
+            sideCount += binCounts[bin];
+            rightCost[bin] = sideCount * side.halfPerimeter();
+        }
+        
+        double bestCost = std::numeric_limits<double>::infinity();
+        size_t bestBin = 0;  // Split after this bin
+        side = Bounds();
+        sideCount = 0;
+        for (size_t bin = 0; bin + 1 < SAH_BINS; ++bin) {
+            side.merge(binBounds[bin]);
+            sideCount += binCounts[bin];
+            if (sideCount == 0 || sideCount == count) continue;
+            double cost = sideCount * side.halfPerimeter() + rightCost[bin + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestBin = bin;
+            }
+        }
+        if (bestCost < std::numeric_limits<double>::infinity()) {
+            auto middle = std::partition(order.begin() + first, order.begin() + last,
+                                         [&](std::uint32_t shape) { return binOf(shape) <= bestBin; });
+            mid = static_cast<std::uint32_t>(middle - order.begin());
+            split = true;
+        }
+    }
+    if (!split && extent > 0) {
+        std::nth_element(order.begin() + first, order.begin() + mid, order.begin() + last,
+                         [&](std::uint32_t a, std::uint32_t b) {
+                             return centerOn(shapeBounds[a], alongX) < centerOn(shapeBounds[b], alongX);
+                         });
+    }
+    // With every centroid on one point any halving is as good as another
+    
+    buildNode(first, mid, index, depth + 1);  // Lands at index + 1
+    std::uint32_t right = buildNode(mid, last, index, depth + 1);
+    nodes[index].first = right;
+    return index;
+}
+
+bool ShapeBvh::refitNode(std::uint32_t index) {
+    Node& node = nodes[index];
+    Bounds bounds;
+    if (node.count > 0) {
+        for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+            bounds.merge(shapeBounds[order[i]]);
+        }
+    } else {
+        bounds.merge(nodes[index + 1].bounds);
+        bounds.merge(nodes[node.first].bounds);
+    }
+    if (bounds == node.bounds) return false;
+    node.bounds = bounds;
+    return true;
+}
+
+void ShapeBvh::update(size_t index) {
+    if (index >= shapeBounds.size()) {
+        throw std::invalid_argument("Shape index out of range");
+    }
+    versions[index] = shapes[index].shape->getGeometryVersion();
+    Bounds bounds = shapes[index].getBounds();
+    if (bounds == shapeBounds[index]) return;
+    shapeBounds[index] = bounds;
+    
+    // Walk up until a box stops changing
+    for (std::uint32_t node = leafOf[index]; refitNode(node) && node != 0; node = nodes[node].parent) {}
+}
+
+size_t ShapeBvh::refit() {
+    if (shapes.size() != shapeBounds.size()) {
+        build();
+        return shapes.size();
+    }
+    size_t changed = 0;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        versions[i] = shapes[i].shape->getGeometryVersion();
+        Bounds bounds = shapes[i].getBounds();
+        if (bounds != shapeBounds[i]) {
+            shapeBounds[i] = bounds;
+            ++changed;
+        }
+    }
+    // Children always sit after their parent, so one backwards sweep is bottom-up
+    if (changed > 0) {
+        for (size_t node = nodes.size(); node-- > 0;) {
+            refitNode(static_cast<std::uint32_t>(node));
+        }
+    }
+    return changed;
+}
+
+bool ShapeBvh::isStale() const {
+    if (shapes.size() != shapeBounds.size()) return true;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (shapes[i].shape->getGeometryVersion() != versions[i]) return true;
+    }
+    return false;
+}
+
+template<typename NodeTest, typename Hit>
+void ShapeBvh::traverse(NodeTest nodeTest, Hit hit) const {
+    if (nodes.empty()) return;
+    
+    // Depth is bounded (see SAH_MAX_DEPTH), so a fixed stack is enough
+    std::uint32_t stack[STACK_SIZE];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        std::uint32_t index = stack[--top];
+        const Node& node = nodes[index];
+        if (!nodeTest(node.bounds)) continue;
+        if (node.count > 0) {
+            for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if (nodeTest(shapeBounds[order[i]])) hit(order[i]);
+            }
+        } else {
+            stack[top++] = node.first;
+            stack[top++] = index + 1;
+        }
+    }
+}
+
+size_t ShapeBvh::findInRegion(const Bounds& region, std::vector<size_t>& out) const {
+    size_t before = out.size();
+    traverse([&](const Bounds& b) { return b.overlaps(region); },
+             [&](std::uint32_t shape) { out.push_back(shape); });
+    return out.size() - before;
+}
+
+size_t ShapeBvh::findAtPoint(const Point& p, std::vector<size_t>& out) const {
+    size_t before = out.size();
+    traverse([&](const Bounds& b) { return b.contains(p); },
+             [&](std::uint32_t shape) {
+                 if (shapes[shape].contains(p)) out.push_back(shape);
+             });
+    return out.size() - before;
+}
+
+size_t ShapeBvh::findOverlapping(size_t index, std::vector<size_t>& out) const {
+    if (index >= shapeBounds.size()) {
+        throw std::invalid_argument("Shape index out of range");
+    }
+    size_t before = out.size();
+    const Bounds region = shapeBounds[index];
+    traverse([&](const Bounds& b) { return b.overlaps(region); },
+             [&](std::uint32_t shape) {
+                 if (shape != index) out.push_back(shape);
+             });
+    return out.size() - before;
+}
+
+Bounds ShapeBvh::getBounds() const {
+    return nodes.empty() ? Bounds() : nodes[0].bounds;
+}
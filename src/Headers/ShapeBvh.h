@@ -0,0 +1,90 @@
+// ============================================================================
+// FILE: shape_bvh.h - Bounding volume hierarchy over positioned shapes
+// ============================================================================
+#ifndef SHAPE_BVH_H
+#define SHAPE_BVH_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Bounds.h"
+
+struct PositionedShape;  // Only used by reference
+
+// Binary tree of bounding boxes for a set of shapes that rarely changes.
+// Splits are chosen with the surface area heuristic over binned centroids, so
+// a query only descends into boxes it touches: O(log n + hits) for small
+// regions, however many shapes the scene holds.
+//
+// The tree keeps a reference to the vector and answers with indices into it.
+// After a shape is resized (setRadius/setDimensions) or moved, either call
+// update(index) for that shape or refit() for all of them; both only widen or
+// shrink boxes, the tree shape is kept. Appending or removing shapes needs
+// build() (or refit(), which notices the new size).
+class ShapeBvh {
+public:
+    explicit ShapeBvh(const std::vector<PositionedShape>& shapes_i);
+    
+    // Rebuild the whole tree from the current shapes
+    void build();
+    
+    // Recompute one shape's box and the boxes above it
+    void update(size_t index);
+    
+    // Recompute every shape's box and every node box, returns how many shapes
+    // changed. Cheaper than build() and leaves query results exact, but
+    // queries slow down if shapes drift far from where they were built.
+    // Falls back to build() if the vector changed size.
+    size_t refit();
+    
+    // True once some shape has been resized since the tree last saw it
+    // (build, refit or its own update). Compares every shape's version, so
+    // O(n), but no shape outside this vector can make the tree stale. Moves
+    // are not seen here, since positions are plain data.
+    bool isStale() const;
+    
+    // Queries append indices of matching shapes to out (in no particular
+    // order) and return how many they appended
+    size_t findInRegion(const Bounds& region, std::vector<size_t>& out) const;  // Bounds overlap region
+    size_t findAtPoint(const Point& p, std::vector<size_t>& out) const;          // Shape contains p
+    size_t findOverlapping(size_t index, std::vector<size_t>& out) const;       // Bounds overlap shape index's, itself excluded
+    
+    // Box around every shape, empty for an empty set
+    Bounds getBounds() const;
+    
+    size_t size() const { return shapeBounds.size(); }
+    size_t getNodeCount() const { return nodes.size(); }
+    
+    static constexpr size_t MAX_LEAF = 4;   // Shapes per leaf
+    static constexpr size_t SAH_BINS = 16;  // Candidate split planes per node
+    
+private:
+    // Children of an internal node are left = this + 1 and right = first;
+    // a leaf covers order[first, first + count)
+    struct Node {
+        Bounds bounds;
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;  // 0 for internal nodes
+        std::uint32_t parent = 0;
+    };
+    
+    // Build the subtree over order[first, last) at depth, returns its node
+    std::uint32_t buildNode(std::uint32_t first, std::uint32_t last, std::uint32_t parent, size_t depth);
+    
+    // Recompute node's box from its shapes or children, true if it changed
+    bool refitNode(std::uint32_t node);
+    
+    // Walk every node whose box passes nodeTest, calling hit for each shape
+    // whose box passes it too
+    template<typename NodeTest, typename Hit>
+    void traverse(NodeTest nodeTest, Hit hit) const;
+    
+    const std::vector<PositionedShape>& shapes;
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> order;       // Shape indices, grouped by leaf
+    std::vector<Bounds> shapeBounds;        // Box of each shape, by shape index
+    std::vector<std::uint32_t> leafOf;      // Leaf holding each shape, by shape index
+    std::vector<std::uint64_t> versions;    // Geometry version each box was computed at, by shape index
+};
+
+#endif // SHAPE_BVH_H
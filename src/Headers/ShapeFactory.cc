@@ -4,10 +4,83 @@
 #include "ShapeFactory.h"
 #include "Circle.h"      // Now we need the full definitions
 #include "Rectangle.h"
-#include <sstream>
+#include "ShapeStore.h"
+#include "CachedShape.h"
+#include "ThreadPool.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
 #include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Whether createShape hands out shapes that cache their area and perimeter
+std::atomic<bool> geometryCaching{false};
+
+// Bulk imports parse the text in pieces of about this many bytes, cut at line ends
+constexpr size_t IMPORT_CHUNK_BYTES = 1 << 20;
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Next blank-separated word of rest, which is advanced past it
+std::string_view nextWord(std::string_view& rest) {
+    size_t first = 0;
+    while (first < rest.size() && isBlank(rest[first])) ++first;
+    size_t last = first;
+    while (last < rest.size() && !isBlank(rest[last])) ++last;
+    std::string_view word = rest.substr(first, last - first);
+    rest.remove_prefix(last);
+    return word;
+}
+
+// Next number of rest, parsed in place without copying or locale lookups
+double nextNumber(std::string_view& rest) {
+    std::string_view word = nextWord(rest);
+    if (word.empty()) {
+        throw std::invalid_argument("Missing number");
+    }
+    double value = 0;
+    auto [end, error] = std::from_chars(word.data(), word.data() + word.size(), value);
+    if (error != std::errc() || end != word.data() + word.size() || !std::isfinite(value)) {
+        throw std::invalid_argument("Invalid number: " + std::string(word));
+    }
+    return value;
+}
+
+// One line-aligned piece of a bulk import and what came out of it
+struct ImportChunk {
+    size_t begin = 0;        // Byte range in the text
+    size_t end = 0;
+    ShapeStore shapes;
+    bool failed = false;
+    size_t errorLine = 0;    // Line inside the chunk, counted from 0
+    std::string error;
+};
+
+} // namespace
 
 std::unique_ptr<Shape> ShapeFactory::createShape(ShapeType type, double param1, double param2) {
+    if (isGeometryCaching()) {
+        switch (type) {
+            case ShapeType::CIRCLE:
+                return std::make_unique<CachedCircle>(param1);
+                
+            case ShapeType::RECTANGLE:
+                return std::make_unique<CachedRectangle>(param1, param2);
+                
+            case ShapeType::SQUARE:
+                return std::make_unique<CachedRectangle>(param1, param1);
+                
+            default:
+                throw std::invalid_argument("Unknown shape type");
+        }
+    }
+    
     switch (type) {
         case ShapeType::CIRCLE:
             return std::make_unique<Circle>(param1);
@@ -23,22 +96,124 @@ std::unique_ptr<Shape> ShapeFactory::createShape(ShapeType type, double param1,
     }
 }
 
+void ShapeFactory::setGeometryCaching(bool enabled) {
+    geometryCaching.store(enabled);
+}
+
+bool ShapeFactory::isGeometryCaching() {
+    return geometryCaching.load();
+}
+
 std::unique_ptr<Shape> ShapeFactory::createFromDescription(const std::string& description) {
-    std::istringstream iss(description);
-    std::string shapeType;
-    iss >> shapeType;
+    double param1 = 0, param2 = 0;
+    ShapeType type = parseDescription(description, param1, param2);
+    return createShape(type, param1, param2);
+}
+
+size_t ShapeFactory::createShape(ShapeStore& store, ShapeType type, double param1, double param2) {
+    switch (type) {
+        case ShapeType::CIRCLE:
+            return store.addCircle(param1);
+            
+        case ShapeType::RECTANGLE:
+            return store.addRectangle(param1, param2);
+            
+        case ShapeType::SQUARE:
+            return store.addRectangle(param1, param1);
+            
+        default:
+            throw std::invalid_argument("Unknown shape type");
+    }
+}
+
+size_t ShapeFactory::createFromDescription(ShapeStore& store, const std::string& description) {
+    double param1 = 0, param2 = 0;
+    ShapeType type = parseDescription(description, param1, param2);
+    return createShape(store, type, param1, param2);
+}
+
+size_t ShapeFactory::createFromDescriptions(ShapeStore& store, std::string_view text) {
+    return createFromDescriptions(store, text, ThreadPool::shared());
+}
+
+size_t ShapeFactory::createFromDescriptions(ShapeStore& store, std::string_view text, ThreadPool& pool) {
+    // Cut points depend only on the text, so results never depend on the thread count
+    std::vector<ImportChunk> chunks;
+    for (size_t begin = 0; begin < text.size(); ) {
+        size_t end = std::min(begin + IMPORT_CHUNK_BYTES, text.size());
+        if (end < text.size()) {
+            size_t newline = text.find('\n', end - 1);
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+        chunks.emplace_back();
+        chunks.back().begin = begin;
+        chunks.back().end = end;
+        begin = end;
+    }
+    
+    pool.parallelFor(chunks.size(), [&](size_t index) {
+        ImportChunk& chunk = chunks[index];
+        std::string_view rest = text.substr(chunk.begin, chunk.end - chunk.begin);
+        for (size_t line = 0; !rest.empty(); ++line) {
+            size_t newline = rest.find('\n');
+            std::string_view current = rest.substr(0, newline);
+            rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+            if (current.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+            
+            try {
+                double param1 = 0, param2 = 0;
+                ShapeType type = parseDescription(current, param1, param2);
+                createShape(chunk.shapes, type, param1, param2);
+            } catch (const std::invalid_argument& e) {
+                chunk.failed = true;
+                chunk.errorLine = line;
+                chunk.error = e.what();
+                return;
+            }
+        }
+    });
+    
+    // Report the first bad line in file order, before anything is added
+    size_t circles = 0, rectangles = 0;
+    for (const ImportChunk& chunk : chunks) {
+        if (chunk.failed) {
+            size_t line = std::count(text.begin(), text.begin() + chunk.begin, '\n') + chunk.errorLine + 1;
+            throw std::invalid_argument("Line " + std::to_string(line) + ": " + chunk.error);
+        }
+        circles += chunk.shapes.circleCount();
+        rectangles += chunk.shapes.rectangleCount();
+    }
+    
+    store.reserve(store.circleCount() + circles, store.rectangleCount() + rectangles);
+    for (const ImportChunk& chunk : chunks) {
+        store.append(chunk.shapes);
+    }
+    return circles + rectangles;
+}
+
+size_t ShapeFactory::createFromDescriptionFile(ShapeStore& store, const std::string& path) {
+    return createFromDescriptionFile(store, path, ThreadPool::shared());
+}
+
+size_t ShapeFactory::createFromDescriptionFile(ShapeStore& store, const std::string& path, ThreadPool& pool) {
+    MappedFile file(path);
+    return createFromDescriptions(store, file.view(), pool);
+}
+
+ShapeFactory::ShapeType ShapeFactory::parseDescription(std::string_view description, double& param1, double& param2) {
+    std::string_view rest = description;
+    std::string_view shapeType = nextWord(rest);
     
     if (shapeType == "circle") {
-        double radius;
-        iss >> radius;
-        return std::make_unique<Circle>(radius);
+        param1 = nextNumber(rest);
+        return ShapeType::CIRCLE;
     } 
     else if (shapeType == "rectangle") {
-        double width, height;
-        iss >> width >> height;
-        return std::make_unique<Rectangle>(width, height);
+        param1 = nextNumber(rest);
+        param2 = nextNumber(rest);
+        return ShapeType::RECTANGLE;
     }
     else {
-        throw std::invalid_argument("Unknown shape: " + shapeType);
+        throw std::invalid_argument("Unknown shape: " + std::string(shapeType));
     }
 }
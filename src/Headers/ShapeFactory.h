@@ -6,26 +6,51 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include "ShapeKind.h"  // Small enum header, cheaper than a second enum to keep in sync
 
 // Forward declarations instead of including headers (when possible)
 class Shape;  // We only return Shape*, so forward declaration is enough
+class ShapeStore;  // Only used by reference
+class ThreadPool;
 
 // Factory class to create shapes
 class ShapeFactory {
 public:
-    enum class ShapeType {
-        CIRCLE,
-        RECTANGLE,
-        SQUARE
-    };
+    // The kinds a shape can report are exactly the kinds the factory builds
+    using ShapeType = ShapeKind;
     
     // Static factory method returning smart pointer
     static std::unique_ptr<Shape> createShape(ShapeType type, double param1, double param2 = 0);
     
+    // Opt-in: while on, createShape and createFromDescription return
+    // CachedCircle/CachedRectangle, which remember their area and perimeter
+    static void setGeometryCaching(bool enabled);
+    static bool isGeometryCaching();
+    
     // Create from string description
     static std::unique_ptr<Shape> createFromDescription(const std::string& description);
     
+    // Create straight into a data-oriented store, returns the row in the shape's column
+    static size_t createShape(ShapeStore& store, ShapeType type, double param1, double param2 = 0);
+    static size_t createFromDescription(ShapeStore& store, const std::string& description);
+    
+    // Bulk import of one description per line (blank lines skipped) into a store.
+    // Line ranges are parsed in parallel and appended in file order; returns the
+    // number of shapes added. On a bad line nothing is added and
+    // std::invalid_argument names the line.
+    static size_t createFromDescriptions(ShapeStore& store, std::string_view text);
+    static size_t createFromDescriptions(ShapeStore& store, std::string_view text, ThreadPool& pool);
+    
+    // Same, reading a memory-mapped file; throws std::runtime_error if unreadable
+    static size_t createFromDescriptionFile(ShapeStore& store, const std::string& path);
+    static size_t createFromDescriptionFile(ShapeStore& store, const std::string& path, ThreadPool& pool);
+    
 private:
+    // Split "circle 3.5" / "rectangle 2 8" into a type and its parameters
+    static ShapeType parseDescription(std::string_view description, double& param1, double& param2);
+    
     // Private constructor prevents instantiation
     ShapeFactory() = default;
 };
@@ -0,0 +1,377 @@
+// ============================================================================
+// FILE: shape_file.cc
+// ============================================================================
+#include "ShapeFile.h"
+#include "ShapeStore.h"
+#include "PositionedShape.h"
+#include "Circle.h"
+#include "Rectangle.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+const char MAGIC[8] = {'S', 'H', 'A', 'P', 'E', 'C', 'O', 'L'};
+constexpr std::uint32_t ORDER_MARK = 0x01020304;  // Reads back swapped on a machine of the other endianness
+constexpr std::uint32_t HAS_POSITIONS = 1;
+constexpr std::uint64_t DATA_OFFSET = 256;   // First column, the header is padded up to here
+constexpr std::uint64_t COLUMN_ALIGN = 64;   // Cache line, and enough for any SIMD load
+
+struct ColumnEntry {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    std::uint64_t checksum;
+};
+
+// On-disk header; fixed-width fields only, so the layout has no padding
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint32_t byteOrder;
+    std::uint32_t reserved;
+    std::uint64_t shapeCount;
+    std::uint64_t circleCount;
+    std::uint64_t rectangleCount;
+    std::uint64_t chunkBytes;
+    ColumnEntry columns[6];
+    std::uint64_t headerChecksum;  // Of the header with this field zeroed
+};
+static_assert(sizeof(Header) == 208 && sizeof(Header) <= DATA_OFFSET, "Header layout changed");
+
+// Checksum in the style of xxHash64: four independent lanes over 8-byte
+// words, so it runs at memory speed. Not compatible with xxHash itself.
+constexpr std::uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t PRIME3 = 0x165667B19E3779F9ull;
+
+std::uint64_t rotateLeft(std::uint64_t x, int bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+std::uint64_t mixWord(std::uint64_t lane, std::uint64_t word) {
+    return rotateLeft(lane + word * PRIME2, 31) * PRIME1;
+}
+
+std::uint64_t readWord(const char* p) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+std::uint64_t checksumChunk(const char* data, size_t bytes, std::uint64_t seed) {
+    std::uint64_t lanes[4] = {seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1};
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            lanes[lane] = mixWord(lanes[lane], readWord(data + i + 8 * lane));
+        }
+    }
+    std::uint64_t h = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7)
+                    + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18) + bytes;
+    for (; i + 8 <= bytes; i += 8) {
+        h = rotateLeft(h ^ mixWord(0, readWord(data + i)), 27) * PRIME1 + PRIME3;
+    }
+    for (; i < bytes; ++i) {
+        h = rotateLeft(h ^ static_cast<unsigned char>(data[i]) * PRIME3, 11) * PRIME1;
+    }
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+// A column's checksum chains the checksums of its chunks, so the writer can
+// compute it one buffer at a time
+std::uint64_t checksumColumn(const char* data, std::uint64_t bytes, std::uint64_t chunkBytes) {
+    std::uint64_t checksum = 0;
+    for (std::uint64_t first = 0; first < bytes; first += chunkBytes) {
+        checksum = checksumChunk(data + first, std::min(chunkBytes, bytes - first), checksum);
+    }
+    return checksum;
+}
+
+// Streams columns into one file through a single reusable chunk buffer
+class ColumnWriter {
+public:
+    explicit ColumnWriter(const std::string& path_i) : path(path_i), out(path_i, std::ios::binary | std::ios::trunc) {
+        if (!out) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        pad(DATA_OFFSET);  // Header goes in last, once the checksums are known
+    }
+    
+    // Write count elements of T, produced in order by fill(buffer, n)
+    template<typename T, typename Fill>
+    ColumnEntry write(size_t count, Fill fill) {
+        pad((position + COLUMN_ALIGN - 1) / COLUMN_ALIGN * COLUMN_ALIGN);
+        ColumnEntry entry{position, count * sizeof(T), 0};
+        const size_t perChunk = ShapeFile::CHUNK_BYTES / sizeof(T);
+        buffer.resize(ShapeFile::CHUNK_BYTES);
+        for (size_t first = 0; first < count; first += perChunk) {
+            size_t n = std::min(perChunk, count - first);
+            T* chunk = reinterpret_cast<T*>(buffer.data());
+            fill(chunk, n);
+            entry.checksum = checksumChunk(buffer.data(), n * sizeof(T), entry.checksum);
+            emit(buffer.data(), n * sizeof(T));
+        }
+        return entry;
+    }
+    
+    void finish(Header& header) {
+        header.headerChecksum = 0;
+        header.headerChecksum = checksumChunk(reinterpret_cast<const char*>(&header), sizeof(header), 0);
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+    }
+    
+private:
+    void pad(std::uint64_t to) {
+        static const char zeros[DATA_OFFSET] = {};
+        emit(zeros, to - position);
+    }
+    
+    void emit(const char* data, size_t bytes) {
+        out.write(data, static_cast<std::streamsize>(bytes));
+        if (!out) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        position += bytes;
+    }
+    
+    std::string path;
+    std::ofstream out;
+    std::uint64_t position = 0;
+    std::vector<char> buffer;  // char storage; operator new aligns it for any T
+};
+
+Header makeHeader(size_t shapes, size_t circles, size_t rectangles, bool positioned) {
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = ShapeFile::VERSION;
+    header.flags = positioned ? HAS_POSITIONS : 0;
+    header.byteOrder = ORDER_MARK;
+    header.shapeCount = shapes;
+    header.circleCount = circles;
+    header.rectangleCount = rectangles;
+    header.chunkBytes = ShapeFile::CHUNK_BYTES;
+    return header;
+}
+
+// Copy the next n values of a column, advancing the cursor
+auto copyFrom(const double* column) {
+    return [column, next = size_t(0)](double* out, size_t n) mutable {
+        std::memcpy(out, column + next, n * sizeof(double));
+        next += n;
+    };
+}
+}
+
+void ShapeFile::write(const std::string& path, const ShapeStore& store) {
+    const std::vector<double>& widths = store.getWidths();
+    const std::vector<double>& heights = store.getHeights();
+    Header header = makeHeader(store.size(), store.circleCount(), store.rectangleCount(), false);
+    ColumnWriter writer(path);
+    
+    // Same order as the store: every circle, then every rectangle
+    size_t next = 0;
+    header.columns[KIND] = writer.write<std::uint8_t>(store.size(), [&](std::uint8_t* out, size_t n) {
+        for (size_t k = 0; k < n; ++k, ++next) {
+            ShapeKind kind = ShapeKind::CIRCLE;
+            if (next >= store.circleCount()) {
+                size_t row = next - store.circleCount();
+                kind = widths[row] == heights[row] ? ShapeKind::SQUARE : ShapeKind::RECTANGLE;
+            }
+            out[k] = static_cast<std::uint8_t>(kind);
+        }
+    });
+    header.columns[RADIUS] = writer.write<double>(store.circleCount(), copyFrom(store.getRadii().data()));
+    header.columns[WIDTH] = writer.write<double>(store.rectangleCount(), copyFrom(widths.data()));
+    header.columns[HEIGHT] = writer.write<double>(store.rectangleCount(), copyFrom(heights.data()));
+    writer.finish(header);
+}
+
+void ShapeFile::write(const std::string& path, const std::vector<PositionedShape>& scene) {
+    size_t circleTotal = 0;
+    for (const PositionedShape& placed : scene) {
+        if (!placed.shape) {
+            throw std::invalid_argument("Cannot store an empty shape");
+        }
+        if (dynamic_cast<const Circle*>(placed.shape.get())) {
+            ++circleTotal;
+        } else if (!dynamic_cast<const Rectangle*>(placed.shape.get())) {
+            throw std::invalid_argument("Cannot store shape: " + placed.shape->getName());
+        }
+    }
+    Header header = makeHeader(scene.size(), circleTotal, scene.size() - circleTotal, true);
+    ColumnWriter writer(path);
+    
+    // Each parameter column walks the scene with its own cursor, skipping other types
+    size_t next = 0;
+    header.columns[KIND] = writer.write<std::uint8_t>(scene.size(), [&](std::uint8_t* out, size_t n) {
+        for (size_t k = 0; k < n; ++k) out[k] = static_cast<std::uint8_t>(scene[next++].shape->getKind());
+    });
+    next = 0;
+    header.columns[RADIUS] = writer.write<double>(circleTotal, [&](double* out, size_t n) {
+        for (size_t k = 0; k < n; ++next) {
+            if (const auto* circle = dynamic_cast<const Circle*>(scene[next].shape.get())) out[k++] = circle->getRadius();
+        }
+    });
+    auto rectangleColumn = [&](bool width) {
+        next = 0;
+        return writer.write<double>(scene.size() - circleTotal, [&, width](double* out, size_t n) {
+            for (size_t k = 0; k < n; ++next) {
+                if (const auto* rectangle = dynamic_cast<const Rectangle*>(scene[next].shape.get())) {
+                    out[k++] = width ? rectangle->getWidth() : rectangle->getHeight();
+                }
+            }
+        });
+    };
+    header.columns[WIDTH] = rectangleColumn(true);
+    header.columns[HEIGHT] = rectangleColumn(false);
+    next = 0;
+    header.columns[X] = writer.write<double>(scene.size(), [&](double* out, size_t n) {
+        for (size_t k = 0; k < n; ++k) out[k] = scene[next++].position.x;
+    });
+    next = 0;
+    header.columns[Y] = writer.write<double>(scene.size(), [&](double* out, size_t n) {
+        for (size_t k = 0; k < n; ++k) out[k] = scene[next++].position.y;
+    });
+    writer.finish(header);
+}
+
+ShapeFile::ShapeFile(const std::string& path, bool verifyColumns) : file(path) {
+    Header header;
+    if (file.size() < DATA_OFFSET) {
+        throw std::runtime_error("Not a shape file: " + path);
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a shape file: " + path);
+    }
+    if (header.byteOrder != ORDER_MARK) {
+        throw std::runtime_error("Shape file written with the other byte order: " + path);
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("Unsupported shape file version " + std::to_string(header.version) + ": " + path);
+    }
+    Header unsummed = header;
+    unsummed.headerChecksum = 0;
+    if (checksumChunk(reinterpret_cast<const char*>(&unsummed), sizeof(unsummed), 0) != header.headerChecksum) {
+        throw std::runtime_error("Corrupt shape file header: " + path);
+    }
+    
+    // Every shape takes at least a kind byte, which keeps the sizes below from overflowing
+    positioned = (header.flags & HAS_POSITIONS) != 0;
+    if (header.shapeCount > file.size() || header.circleCount > header.shapeCount ||
+        header.rectangleCount != header.shapeCount - header.circleCount || header.chunkBytes == 0) {
+        throw std::runtime_error("Corrupt shape file header: " + path);
+    }
+    const std::uint64_t expected[COLUMN_COUNT] = {
+        header.shapeCount, header.circleCount * sizeof(double),
+        header.rectangleCount * sizeof(double), header.rectangleCount * sizeof(double),
+        positioned ? header.shapeCount * sizeof(double) : 0, positioned ? header.shapeCount * sizeof(double) : 0
+    };
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        const ColumnEntry& entry = header.columns[c];
+        if (entry.bytes != expected[c] || (expected[c] > 0 && (entry.offset < DATA_OFFSET ||
+            entry.offset % sizeof(double) != 0 || entry.offset > file.size() || entry.bytes > file.size() - entry.offset))) {
+            throw std::runtime_error("Corrupt shape file header: " + path);
+        }
+        offsets[c] = entry.offset;
+        lengths[c] = entry.bytes;
+        checksums[c] = entry.checksum;
+    }
+    shapeCount = header.shapeCount;
+    circles = header.circleCount;
+    rectangles = header.rectangleCount;
+    chunkBytes = header.chunkBytes;
+    
+    if (verifyColumns && !verify()) {
+        throw std::runtime_error("Corrupt shape file: " + path);
+    }
+}
+
+bool ShapeFile::verify() const {
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        if (checksumColumn(column(static_cast<Column>(c)), lengths[c], chunkBytes) != checksums[c]) return false;
+    }
+    return true;
+}
+
+const char* ShapeFile::column(Column which) const {
+    return file.data() + offsets[which];
+}
+
+const std::uint8_t* ShapeFile::getKinds() const {
+    return reinterpret_cast<const std::uint8_t*>(column(KIND));
+}
+
+const double* ShapeFile::getRadii() const {
+    return reinterpret_cast<const double*>(column(RADIUS));
+}
+
+const double* ShapeFile::getWidths() const {
+    return reinterpret_cast<const double*>(column(WIDTH));
+}
+
+const double* ShapeFile::getHeights() const {
+    return reinterpret_cast<const double*>(column(HEIGHT));
+}
+
+const double* ShapeFile::getX() const {
+    return positioned ? reinterpret_cast<const double*>(column(X)) : nullptr;
+}
+
+const double* ShapeFile::getY() const {
+    return positioned ? reinterpret_cast<const double*>(column(Y)) : nullptr;
+}
+
+ShapeStoreView ShapeFile::view() const {
+    return ShapeStoreView(getRadii(), circles, getWidths(), getHeights(), rectangles);
+}
+
+void ShapeFile::loadInto(ShapeStore& store) const {
+    try {
+        store.appendColumns(getRadii(), circles, getWidths(), getHeights(), rectangles);
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error(std::string("Corrupt shape file: ") + e.what());
+    }
+}
+
+std::vector<PositionedShape> ShapeFile::loadScene() const {
+    const std::uint8_t* kinds = getKinds();
+    const double* x = getX();
+    const double* y = getY();
+    std::vector<PositionedShape> scene;
+    scene.reserve(shapeCount);
+    size_t circle = 0;
+    size_t rectangle = 0;
+    for (size_t i = 0; i < shapeCount; ++i) {
+        std::unique_ptr<Shape> shape;
+        try {
+            if (kinds[i] == static_cast<std::uint8_t>(ShapeKind::CIRCLE) && circle < circles) {
+                shape = std::make_unique<Circle>(getRadii()[circle++]);
+            } else if ((kinds[i] == static_cast<std::uint8_t>(ShapeKind::RECTANGLE) ||
+                        kinds[i] == static_cast<std::uint8_t>(ShapeKind::SQUARE)) && rectangle < rectangles) {
+                shape = std::make_unique<Rectangle>(getWidths()[rectangle], getHeights()[rectangle]);
+                ++rectangle;
+            } else {
+                throw std::runtime_error("Corrupt shape file: kind column does not match the counts");
+            }
+        } catch (const std::invalid_argument& e) {
+            // The constructors reject values the writer never produces
+            throw std::runtime_error(std::string("Corrupt shape file: ") + e.what());
+        }
+        scene.emplace_back(std::move(shape), positioned ? Point{x[i], y[i]} : Point{});
+    }
+    return scene;
+}
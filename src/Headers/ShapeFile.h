@@ -0,0 +1,100 @@
+// ============================================================================
+// FILE: shape_file.h - Columnar binary files of shapes
+// ============================================================================
+#ifndef SHAPE_FILE_H
+#define SHAPE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"  // Held by value
+#include "ShapeStore.h"   // ShapeStoreView returned by value
+
+struct PositionedShape;
+
+// A shape collection stored column by column, in the same layout ShapeStore
+// keeps in memory:
+//
+//   header (256 bytes)  magic, version, counts, where each column starts,
+//                       a checksum per column and one over the header itself
+//   kind column         one ShapeKind byte per shape, in collection order
+//   radius column       one double per circle
+//   width, height       one double each per rectangle (squares included)
+//   x, y columns        one double each per shape, only in files written
+//                       from positioned shapes
+//
+// Columns start on 64-byte boundaries and hold native little-endian values,
+// so a mapped file can be read in place with no parsing at all. Files are
+// written and checksummed in CHUNK_BYTES pieces, so writing never needs a
+// second copy of a column in memory.
+//
+// Opening reads only the header. Columns are paged in when first touched:
+// view() touches nothing until a kernel runs, loadInto and verify read every
+// column once more each.
+class ShapeFile {
+public:
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr size_t CHUNK_BYTES = size_t(1) << 20;
+
+    // Write a store (no position columns) or a scene; throws std::runtime_error
+    // if the file cannot be written and std::invalid_argument for a shape that
+    // is neither a Circle nor a Rectangle
+    static void write(const std::string& path, const ShapeStore& store);
+    static void write(const std::string& path, const std::vector<PositionedShape>& scene);
+
+    // Map path and check its header, which keeps every column inside the
+    // file. The column checksums are only checked with verify = true, a full
+    // extra pass over the file; otherwise call verify() when it is worth it.
+    // Throws std::runtime_error for a missing, truncated or corrupt file.
+    explicit ShapeFile(const std::string& path, bool verify = false);
+
+    // True if every column matches its checksum (reads the whole file)
+    bool verify() const;
+
+    size_t size() const { return shapeCount; }
+    size_t circleCount() const { return circles; }
+    size_t rectangleCount() const { return rectangles; }
+    bool hasPositions() const { return positioned; }
+
+    // Columns, read in place from the mapping (valid while this object lives).
+    // getX/getY return nullptr if the file has no positions.
+    const std::uint8_t* getKinds() const;
+    const double* getRadii() const;
+    const double* getWidths() const;
+    const double* getHeights() const;
+    const double* getX() const;
+    const double* getY() const;
+
+    // The parameter columns read in place, valid while this object lives.
+    // Nothing is copied or checked: unless verify() passed, a damaged column
+    // gives wrong results, though never a read outside the file.
+    ShapeStoreView view() const;
+
+    // Append the parameter columns to store: one pass checking every value
+    // is positive, then a copy of each column, so O(n) time and a second
+    // copy of the data in memory. Use view() to avoid both. Throws
+    // std::runtime_error for a value no shape can have; store is unchanged.
+    void loadInto(ShapeStore& store) const;
+
+    // Rebuild the shapes in file order, at the origin if there are no positions.
+    // Throws std::runtime_error if the kind column or a value is corrupt.
+    std::vector<PositionedShape> loadScene() const;
+
+private:
+    enum Column { KIND, RADIUS, WIDTH, HEIGHT, X, Y, COLUMN_COUNT };
+
+    const char* column(Column which) const;
+
+    MappedFile file;
+    size_t shapeCount = 0;
+    size_t circles = 0;
+    size_t rectangles = 0;
+    bool positioned = false;
+    std::uint64_t chunkBytes = CHUNK_BYTES;  // Piece size the checksums were chained over
+    std::uint64_t offsets[COLUMN_COUNT] = {};
+    std::uint64_t lengths[COLUMN_COUNT] = {};
+    std::uint64_t checksums[COLUMN_COUNT] = {};
+};
+
+#endif // SHAPE_FILE_H
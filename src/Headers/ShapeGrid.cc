@@ -0,0 +1,199 @@
+// ============================================================================
+// FILE: shape_grid.cc
+// ============================================================================
+#include "ShapeGrid.h"
+#include "PositionedShape.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+// Cell coordinates are clamped so the conversion from double stays defined
+constexpr double MAX_CELL = 4e18;
+
+std::int64_t toCell(double coordinate, double cellSize) {
+    return static_cast<std::int64_t>(std::clamp(std::floor(coordinate / cellSize), -MAX_CELL, MAX_CELL));
+}
+}
+
+ShapeGrid::ShapeGrid(const std::vector<PositionedShape>& shapes_i, double cellSize_i)
+    : shapes(shapes_i), cellSize(cellSize_i) {
+    if (!(cellSize_i > 0)) {
+        throw std::invalid_argument("Cell size must be positive");
+    }
+    entries.reserve(shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        insert(i);
+    }
+}
+
+ShapeGrid::CellRange ShapeGrid::cellsOf(const Bounds& bounds) const {
+    return CellRange{toCell(bounds.minX, cellSize), toCell(bounds.minY, cellSize),
+                     toCell(bounds.maxX, cellSize), toCell(bounds.maxY, cellSize)};
+}
+
+bool ShapeGrid::isLarge(const CellRange& range) {
+    // In doubles, so ranges near the clamp cannot overflow
+    double cellCount = (static_cast<double>(range.x1) - range.x0 + 1) * (static_cast<double>(range.y1) - range.y0 + 1);
+    return cellCount > MAX_CELLS_PER_SHAPE;
+}
+
+// Far-apart cells may share a key; every hit is checked against the shape's
+// own bounds, so that only costs a little extra filtering. A filed shape spans
+// at most MAX_CELLS_PER_SHAPE cells, so no two of its own cells share a key.
+std::uint64_t ShapeGrid::cellKey(std::int64_t x, std::int64_t y) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+}
+
+void ShapeGrid::link(std::uint32_t index, const CellRange& range) {
+    if (isLarge(range)) {
+        largeShapes.push_back(index);
+        return;
+    }
+    for (std::int64_t x = range.x0; x <= range.x1; ++x) {
+        for (std::int64_t y = range.y0; y <= range.y1; ++y) {
+            cells[cellKey(x, y)].push_back(index);
+        }
+    }
+}
+
+void ShapeGrid::unlink(std::uint32_t index, const CellRange& range) {
+    if (isLarge(range)) {
+        *std::find(largeShapes.begin(), largeShapes.end(), index) = largeShapes.back();
+        largeShapes.pop_back();
+        return;
+    }
+    for (std::int64_t x = range.x0; x <= range.x1; ++x) {
+        for (std::int64_t y = range.y0; y <= range.y1; ++y) {
+            auto cell = cells.find(cellKey(x, y));
+            std::vector<std::uint32_t>& members = cell->second;
+            *std::find(members.begin(), members.end(), index) = members.back();  // Order in a cell does not matter
+            members.pop_back();
+            if (members.empty()) cells.erase(cell);
+        }
+    }
+}
+
+void ShapeGrid::insert(size_t index) {
+    if (index >= shapes.size() || index > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Shape index out of range");
+    }
+    if (index >= entries.size()) entries.resize(index + 1);
+    Entry& entry = entries[index];
+    if (entry.tracked) return;
+    
+    entry.version = shapes[index].shape->getGeometryVersion();
+    entry.bounds = shapes[index].getBounds();
+    entry.range = cellsOf(entry.bounds);
+    link(static_cast<std::uint32_t>(index), entry.range);
+    entry.tracked = true;
+    ++trackedCount;
+}
+
+void ShapeGrid::remove(size_t index) {
+    if (!isTracked(index)) return;
+    Entry& entry = entries[index];
+    unlink(static_cast<std::uint32_t>(index), entry.range);
+    entry.tracked = false;
+    --trackedCount;
+}
+
+void ShapeGrid::update(size_t index) {
+    if (!isTracked(index)) {
+        throw std::invalid_argument("Shape is not in the grid");
+    }
+    Entry& entry = entries[index];
+    entry.version = shapes[index].shape->getGeometryVersion();
+    Bounds bounds = shapes[index].getBounds();
+    if (bounds == entry.bounds) return;
+    
+    // Most moves stay inside the same cells, then only the box is updated
+    CellRange range = cellsOf(bounds);
+    if (range.x0 != entry.range.x0 || range.y0 != entry.range.y0 ||
+        range.x1 != entry.range.x1 || range.y1 != entry.range.y1) {
+        unlink(static_cast<std::uint32_t>(index), entry.range);
+        link(static_cast<std::uint32_t>(index), range);
+        entry.range = range;
+    }
+    entry.bounds = bounds;
+}
+
+size_t ShapeGrid::refit() {
+    size_t changed = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!entries[i].tracked) continue;
+        if (shapes[i].getBounds() != entries[i].bounds) ++changed;
+        update(i);
+    }
+    return changed;
+}
+
+bool ShapeGrid::isStale() const {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].tracked && shapes[i].shape->getGeometryVersion() != entries[i].version) return true;
+    }
+    return false;
+}
+
+template<typename Hit>
+void ShapeGrid::visit(const Bounds& region, Hit hit) const {
+    if (region.empty()) return;
+    for (std::uint32_t index : largeShapes) {
+        if (entries[index].bounds.overlaps(region)) hit(index);
+    }
+    if (cells.empty()) return;
+    CellRange query = cellsOf(region);
+    
+    // A shape sits in every cell it touches; report it only from the first
+    // cell it shares with the query, so no seen-set is needed
+    auto scan = [&](std::uint64_t key, const std::vector<std::uint32_t>& members) {
+        for (std::uint32_t index : members) {
+            const Entry& entry = entries[index];
+            if (cellKey(std::max(entry.range.x0, query.x0), std::max(entry.range.y0, query.y0)) == key &&
+                entry.bounds.overlaps(region)) {
+                hit(index);
+            }
+        }
+    };
+    
+    // Walk the query's cells, or the occupied cells if there are fewer of those
+    double queryCells = (static_cast<double>(query.x1) - query.x0 + 1) * (static_cast<double>(query.y1) - query.y0 + 1);
+    if (queryCells > static_cast<double>(cells.size())) {
+        for (const auto& cell : cells) {
+            scan(cell.first, cell.second);
+        }
+        return;
+    }
+    for (std::int64_t x = query.x0; x <= query.x1; ++x) {
+        for (std::int64_t y = query.y0; y <= query.y1; ++y) {
+            auto cell = cells.find(cellKey(x, y));
+            if (cell != cells.end()) scan(cell->first, cell->second);
+        }
+    }
+}
+
+size_t ShapeGrid::findInRegion(const Bounds& region, std::vector<size_t>& out) const {
+    size_t before = out.size();
+    visit(region, [&](std::uint32_t index) { out.push_back(index); });
+    return out.size() - before;
+}
+
+size_t ShapeGrid::findAtPoint(const Point& p, std::vector<size_t>& out) const {
+    size_t before = out.size();
+    visit(Bounds{p.x, p.y, p.x, p.y}, [&](std::uint32_t index) {
+        if (shapes[index].contains(p)) out.push_back(index);
+    });
+    return out.size() - before;
+}
+
+size_t ShapeGrid::findOverlapping(size_t index, std::vector<size_t>& out) const {
+    if (!isTracked(index)) {
+        throw std::invalid_argument("Shape is not in the grid");
+    }
+    size_t before = out.size();
+    visit(entries[index].bounds, [&](std::uint32_t other) {
+        if (other != index) out.push_back(other);
+    });
+    return out.size() - before;
+}
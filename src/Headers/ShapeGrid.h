@@ -0,0 +1,96 @@
+// ============================================================================
+// FILE: shape_grid.h - Uniform hash grid over positioned shapes
+// ============================================================================
+#ifndef SHAPE_GRID_H
+#define SHAPE_GRID_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "Bounds.h"
+
+struct PositionedShape;  // Only used by reference
+
+// Splits the plane into square cells and files each shape under every cell its
+// box touches. Only occupied cells are stored (in a hash map), so the plane is
+// unbounded. Unlike ShapeBvh, changing one shape costs only the cells it
+// leaves and enters, which suits scenes where shapes come, go and move every
+// frame. Queries cost the cells they cover plus the shapes found there; pick
+// a cell size close to a typical shape. A shape covering more than
+// MAX_CELLS_PER_SHAPE cells is not filed in cells at all but kept in a list
+// of large shapes that every query checks, so one huge shape costs each
+// query a box test instead of filling memory with cells.
+//
+// The grid keeps a reference to the vector and answers with indices into it.
+// Shapes are tracked from insert(index) until remove(index); after one is
+// resized or moved call update(index), or refit() for all of them.
+class ShapeGrid {
+public:
+    // Inserts every shape already in the vector; throws std::invalid_argument
+    // if cellSize is not positive
+    ShapeGrid(const std::vector<PositionedShape>& shapes_i, double cellSize);
+    
+    // Start tracking shapes[index] (no-op if tracked already)
+    void insert(size_t index);
+    
+    // Stop tracking shapes[index] (no-op if not tracked)
+    void remove(size_t index);
+    
+    // Refile shapes[index] after it was resized or moved
+    void update(size_t index);
+    
+    // Refile every tracked shape whose box changed, returns how many did
+    size_t refit();
+    
+    // True once some tracked shape has been resized since the grid last saw it
+    // (insert, update or refit). O(n) over the tracked shapes; moves are not seen.
+    bool isStale() const;
+    
+    // Same queries as ShapeBvh, over tracked shapes only
+    size_t findInRegion(const Bounds& region, std::vector<size_t>& out) const;
+    size_t findAtPoint(const Point& p, std::vector<size_t>& out) const;
+    size_t findOverlapping(size_t index, std::vector<size_t>& out) const;
+    
+    bool isTracked(size_t index) const { return index < entries.size() && entries[index].tracked; }
+    size_t size() const { return trackedCount; }
+    size_t getCellCount() const { return cells.size(); }
+    size_t getLargeCount() const { return largeShapes.size(); }
+    double getCellSize() const { return cellSize; }
+    
+    static constexpr double MAX_CELLS_PER_SHAPE = 64;
+    
+private:
+    // Inclusive range of cell coordinates
+    struct CellRange {
+        std::int64_t x0, y0, x1, y1;
+    };
+    
+    struct Entry {
+        Bounds bounds;
+        CellRange range{0, 0, -1, -1};
+        std::uint64_t version = 0;  // Geometry version bounds was computed at
+        bool tracked = false;
+    };
+    
+    CellRange cellsOf(const Bounds& bounds) const;
+    static bool isLarge(const CellRange& range);
+    static std::uint64_t cellKey(std::int64_t x, std::int64_t y);
+    
+    // File entry index under every cell of range (or as a large shape), or take it out again
+    void link(std::uint32_t index, const CellRange& range);
+    void unlink(std::uint32_t index, const CellRange& range);
+    
+    // Call hit once for every tracked shape whose box overlaps region
+    template<typename Hit>
+    void visit(const Bounds& region, Hit hit) const;
+    
+    const std::vector<PositionedShape>& shapes;
+    double cellSize;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cells;  // Occupied cells only
+    std::vector<std::uint32_t> largeShapes;  // Shapes over MAX_CELLS_PER_SHAPE, in no cell
+    std::vector<Entry> entries;  // By shape index
+    size_t trackedCount = 0;
+};
+
+#endif // SHAPE_GRID_H
@@ -0,0 +1,133 @@
+// ============================================================================
+// FILE: shape_kernels.cc - Scalar kernels and runtime dispatch
+// ============================================================================
+#include "ShapeKernels.h"
+#include "ShapeKernelsSimd.h"
+#include "Circle.h"
+#include <atomic>
+
+namespace ShapeKernels {
+
+namespace {
+
+// Plain doubles, one lane wide; also the fallback on non-x86 builds
+struct ScalarOps {
+    using Vec = double;
+    static constexpr size_t WIDTH = 1;
+    
+    static Vec load(const double* p) { return *p; }
+    static void store(double* p, Vec v) { *p = v; }
+    static Vec set1(double x) { return x; }
+    static Vec zero() { return 0.0; }
+    static Vec add(Vec a, Vec b) { return a + b; }
+    static Vec sub(Vec a, Vec b) { return a - b; }
+    static Vec mul(Vec a, Vec b) { return a * b; }
+};
+
+constexpr int ISA_COUNT = 4;
+
+struct Dispatch {
+    KernelTable tables[ISA_COUNT];
+    bool supported[ISA_COUNT];
+    std::atomic<int> active;
+};
+
+// Probe the CPU once, then start on the widest supported implementation
+// (never destroyed, so kernels stay usable from other static destructors)
+Dispatch& dispatch() {
+    static Dispatch* instance = [] {
+        Dispatch* d = new Dispatch{};
+        d->tables[static_cast<int>(Isa::SCALAR)] = makeKernelTable<ScalarOps>();
+        d->supported[static_cast<int>(Isa::SCALAR)] = true;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        d->tables[static_cast<int>(Isa::SSE2)] = sse2KernelTable();
+        d->tables[static_cast<int>(Isa::AVX2)] = avx2KernelTable();
+        d->tables[static_cast<int>(Isa::AVX512)] = avx512KernelTable();
+        d->supported[static_cast<int>(Isa::SSE2)] = __builtin_cpu_supports("sse2");
+        d->supported[static_cast<int>(Isa::AVX2)] = __builtin_cpu_supports("avx2");
+        d->supported[static_cast<int>(Isa::AVX512)] = __builtin_cpu_supports("avx512f");
+#endif
+        int best = 0;
+        for (int i = 0; i < ISA_COUNT; ++i) {
+            if (d->supported[i]) best = i;
+        }
+        d->active.store(best);
+        return d;
+    }();
+    return *instance;
+}
+
+const KernelTable& kernels() {
+    Dispatch& d = dispatch();
+    return d.tables[d.active.load(std::memory_order_relaxed)];
+}
+
+// PI * 1 * 1 and 2 * PI * 1 are exact, so these are Circle's own constants
+double pi() { return Circle::calculateArea(1.0); }
+double twoPi() { return Circle::calculatePerimeter(1.0); }
+
+} // namespace
+
+Isa activeIsa() {
+    return static_cast<Isa>(dispatch().active.load());
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::SSE2:   return "SSE2";
+        case Isa::AVX2:   return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+        default:          return "unknown";
+    }
+}
+
+bool isSupported(Isa isa) {
+    int index = static_cast<int>(isa);
+    return index >= 0 && index < ISA_COUNT && dispatch().supported[index];
+}
+
+bool useIsa(Isa isa) {
+    if (!isSupported(isa)) return false;
+    dispatch().active.store(static_cast<int>(isa));
+    return true;
+}
+
+void circleAreas(const double* radii, double* out, size_t count) {
+    kernels().circleAreas(radii, out, count, pi());
+}
+
+void circlePerimeters(const double* radii, double* out, size_t count) {
+    kernels().circlePerimeters(radii, out, count, twoPi());
+}
+
+void rectangleAreas(const double* widths, const double* heights, double* out, size_t count) {
+    kernels().rectangleAreas(widths, heights, out, count);
+}
+
+void rectanglePerimeters(const double* widths, const double* heights, double* out, size_t count) {
+    kernels().rectanglePerimeters(widths, heights, out, count);
+}
+
+double sum(const double* values, size_t count) {
+    return kernels().sum(values, count);
+}
+
+double sumCircleAreas(const double* radii, size_t count) {
+    return kernels().sumCircleAreas(radii, count, pi());
+}
+
+double sumCirclePerimeters(const double* radii, size_t count) {
+    return kernels().sumCirclePerimeters(radii, count, twoPi());
+}
+
+double sumRectangleAreas(const double* widths, const double* heights, size_t count) {
+    return kernels().sumRectangleAreas(widths, heights, count);
+}
+
+double sumRectanglePerimeters(const double* widths, const double* heights, size_t count) {
+    return kernels().sumRectanglePerimeters(widths, heights, count);
+}
+
+} // namespace ShapeKernels
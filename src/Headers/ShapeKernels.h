@@ -0,0 +1,56 @@
+// ============================================================================
+// FILE: shape_kernels.h - Batch area/perimeter kernels over flat columns
+// ============================================================================
+#ifndef SHAPE_KERNELS_H
+#define SHAPE_KERNELS_H
+
+#include <cstddef>
+
+// Each kernel has a scalar, SSE2, AVX2 and AVX-512 version; the widest one the
+// CPU supports is picked on first use (CPUID via __builtin_cpu_supports).
+//
+// Accuracy contract:
+//  - Per-shape results are bit-identical to Circle/Rectangle::getArea and
+//    getPerimeter on every ISA (same operation order, no fused multiply-add).
+//  - Sums use compensated (Kahan) summation in every vector lane, then fold the
+//    lanes with the same step. For n inputs of one sign (areas, perimeters)
+//    Kahan's error is at most (2u + O(n u^2)) times the exact sum, u = 2^-53:
+//    about 2 ulps plus a term that grows with n. That term stays far below one
+//    ulp for any count that fits in memory (n u^2 < u while n < 2^53), so
+//    totals are within SUM_ULP_BOUND ulps of the exact sum. The ISAs group the
+//    additions differently, so their totals can differ within that bound.
+namespace ShapeKernels {
+    enum class Isa {
+        SCALAR,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+    
+    constexpr int SUM_ULP_BOUND = 4;
+    
+    // Which implementation the kernels currently run
+    Isa activeIsa();
+    const char* isaName(Isa isa);
+    
+    // True if this CPU (and this build) can run the given implementation
+    bool isSupported(Isa isa);
+    
+    // Switch implementation, e.g. to compare them; returns false if unsupported
+    bool useIsa(Isa isa);
+    
+    // Per-shape values written to out, which holds count doubles
+    void circleAreas(const double* radii, double* out, size_t count);
+    void circlePerimeters(const double* radii, double* out, size_t count);
+    void rectangleAreas(const double* widths, const double* heights, double* out, size_t count);
+    void rectanglePerimeters(const double* widths, const double* heights, double* out, size_t count);
+    
+    // Compensated sums; the shape versions never materialize the per-shape values
+    double sum(const double* values, size_t count);
+    double sumCircleAreas(const double* radii, size_t count);
+    double sumCirclePerimeters(const double* radii, size_t count);
+    double sumRectangleAreas(const double* widths, const double* heights, size_t count);
+    double sumRectanglePerimeters(const double* widths, const double* heights, size_t count);
+}
+
+#endif // SHAPE_KERNELS_H
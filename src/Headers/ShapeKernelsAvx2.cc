@@ -0,0 +1,39 @@
+// ============================================================================
+// FILE: shape_kernels_avx2.cc - AVX2 kernels (compiled with -mavx2)
+// ============================================================================
+#include "ShapeKernelsSimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#ifndef __AVX2__
+#error "ShapeKernelsAvx2.cc must be compiled with -mavx2"
+#endif
+
+#include <immintrin.h>
+
+namespace ShapeKernels {
+
+namespace {
+
+struct Avx2Ops {
+    using Vec = __m256d;
+    static constexpr size_t WIDTH = 4;
+    
+    static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    static Vec set1(double x) { return _mm256_set1_pd(x); }
+    static Vec zero() { return _mm256_setzero_pd(); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+};
+
+} // namespace
+
+KernelTable avx2KernelTable() {
+    return makeKernelTable<Avx2Ops>();
+}
+
+} // namespace ShapeKernels
+
+#endif // x86
@@ -0,0 +1,39 @@
+// ============================================================================
+// FILE: shape_kernels_avx512.cc - AVX-512 kernels (compiled with -mavx512f)
+// ============================================================================
+#include "ShapeKernelsSimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#ifndef __AVX512F__
+#error "ShapeKernelsAvx512.cc must be compiled with -mavx512f"
+#endif
+
+#include <immintrin.h>
+
+namespace ShapeKernels {
+
+namespace {
+
+struct Avx512Ops {
+    using Vec = __m512d;
+    static constexpr size_t WIDTH = 8;
+    
+    static Vec load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, Vec v) { _mm512_storeu_pd(p, v); }
+    static Vec set1(double x) { return _mm512_set1_pd(x); }
+    static Vec zero() { return _mm512_setzero_pd(); }
+    static Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+};
+
+} // namespace
+
+KernelTable avx512KernelTable() {
+    return makeKernelTable<Avx512Ops>();
+}
+
+} // namespace ShapeKernels
+
+#endif // x86
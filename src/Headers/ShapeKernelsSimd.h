@@ -0,0 +1,185 @@
+// ============================================================================
+// FILE: shape_kernels_simd.h - Kernel bodies shared by every ISA (internal)
+// ============================================================================
+// Included by one .cc file per ISA, each compiled with its own -m flag. The
+// bodies are written once against a small Ops interface (load, store, add,
+// mul...) and sit in an anonymous namespace, so every .cc file gets a private
+// copy built for its ISA and the linker can never mix them up.
+//
+// Circle.h is deliberately not included: its inline functions compiled with
+// -mavx512f could be the copy the linker keeps for the whole program.
+#ifndef SHAPE_KERNELS_SIMD_H
+#define SHAPE_KERNELS_SIMD_H
+
+#include <cstddef>
+
+namespace ShapeKernels {
+
+// One implementation of every kernel; pi and 2*pi come from Circle
+struct KernelTable {
+    void (*circleAreas)(const double* radii, double* out, size_t count, double pi);
+    void (*circlePerimeters)(const double* radii, double* out, size_t count, double twoPi);
+    void (*rectangleAreas)(const double* widths, const double* heights, double* out, size_t count);
+    void (*rectanglePerimeters)(const double* widths, const double* heights, double* out, size_t count);
+    double (*sum)(const double* values, size_t count);
+    double (*sumCircleAreas)(const double* radii, size_t count, double pi);
+    double (*sumCirclePerimeters)(const double* radii, size_t count, double twoPi);
+    double (*sumRectangleAreas)(const double* widths, const double* heights, size_t count);
+    double (*sumRectanglePerimeters)(const double* widths, const double* heights, size_t count);
+};
+
+// Defined in ShapeKernelsSse2.cc, ShapeKernelsAvx2.cc and ShapeKernelsAvx512.cc
+KernelTable sse2KernelTable();
+KernelTable avx2KernelTable();
+KernelTable avx512KernelTable();
+
+namespace {
+
+template<typename Ops>
+struct SimdKernels {
+    using Vec = typename Ops::Vec;
+    static constexpr size_t WIDTH = Ops::WIDTH;
+    
+    // Same operation order as Circle: (PI * r) * r and (2 * PI) * r
+    static void circleAreas(const double* radii, double* out, size_t count, double pi) {
+        Vec vpi = Ops::set1(pi);
+        size_t i = 0;
+        for (; i + WIDTH <= count; i += WIDTH) {
+            Vec r = Ops::load(radii + i);
+            Ops::store(out + i, Ops::mul(Ops::mul(vpi, r), r));
+        }
+        for (; i < count; ++i) {
+            out[i] = pi * radii[i] * radii[i];
+        }
+    }
+    
+    static void circlePerimeters(const double* radii, double* out, size_t count, double twoPi) {
+        Vec v2pi = Ops::set1(twoPi);
+        size_t i = 0;
+        for (; i + WIDTH <= count; i += WIDTH) {
+            Ops::store(out + i, Ops::mul(v2pi, Ops::load(radii + i)));
+        }
+        for (; i < count; ++i) {
+            out[i] = twoPi * radii[i];
+        }
+    }
+    
+    // Same operation order as Rectangle: w * h and 2 * (w + h)
+    static void rectangleAreas(const double* widths, const double* heights, double* out, size_t count) {
+        size_t i = 0;
+        for (; i + WIDTH <= count; i += WIDTH) {
+            Ops::store(out + i, Ops::mul(Ops::load(widths + i), Ops::load(heights + i)));
+        }
+        for (; i < count; ++i) {
+            out[i] = widths[i] * heights[i];
+        }
+    }
+    
+    static void rectanglePerimeters(const double* widths, const double* heights, double* out, size_t count) {
+        Vec two = Ops::set1(2.0);
+        size_t i = 0;
+        for (; i + WIDTH <= count; i += WIDTH) {
+            Ops::store(out + i, Ops::mul(two, Ops::add(Ops::load(widths + i), Ops::load(heights + i))));
+        }
+        for (; i < count; ++i) {
+            out[i] = 2 * (widths[i] + heights[i]);
+        }
+    }
+    
+    static double sum(const double* values, size_t count) {
+        return compensatedSum(count,
+            [values](size_t i) { return Ops::load(values + i); },
+            [values](size_t i) { return values[i]; });
+    }
+    
+    static double sumCircleAreas(const double* radii, size_t count, double pi) {
+        Vec vpi = Ops::set1(pi);
+        return compensatedSum(count,
+            [radii, vpi](size_t i) { Vec r = Ops::load(radii + i); return Ops::mul(Ops::mul(vpi, r), r); },
+            [radii, pi](size_t i) { return pi * radii[i] * radii[i]; });
+    }
+    
+    static double sumCirclePerimeters(const double* radii, size_t count, double twoPi) {
+        Vec v2pi = Ops::set1(twoPi);
+        return compensatedSum(count,
+            [radii, v2pi](size_t i) { return Ops::mul(v2pi, Ops::load(radii + i)); },
+            [radii, twoPi](size_t i) { return twoPi * radii[i]; });
+    }
+    
+    static double sumRectangleAreas(const double* widths, const double* heights, size_t count) {
+        return compensatedSum(count,
+            [widths, heights](size_t i) { return Ops::mul(Ops::load(widths + i), Ops::load(heights + i)); },
+            [widths, heights](size_t i) { return widths[i] * heights[i]; });
+    }
+    
+    static double sumRectanglePerimeters(const double* widths, const double* heights, size_t count) {
+        Vec two = Ops::set1(2.0);
+        return compensatedSum(count,
+            [widths, heights, two](size_t i) { return Ops::mul(two, Ops::add(Ops::load(widths + i), Ops::load(heights + i))); },
+            [widths, heights](size_t i) { return 2 * (widths[i] + heights[i]); });
+    }
+    
+    // Kahan step: sum gains x, compensation keeps what the rounding dropped (negated)
+    static void kahanAdd(Vec& sum, Vec& compensation, Vec x) {
+        Vec y = Ops::sub(x, compensation);
+        Vec t = Ops::add(sum, y);
+        compensation = Ops::sub(Ops::sub(t, sum), y);
+        sum = t;
+    }
+    
+    static void kahanAddScalar(double& sum, double& compensation, double x) {
+        double y = x - compensation;
+        double t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+    
+    // Two compensated accumulators per lane hide the add latency; lanes and
+    // the scalar tail are folded together with the same compensated step
+    template<typename VecTerm, typename ScalarTerm>
+    static double compensatedSum(size_t count, VecTerm vecTerm, ScalarTerm scalarTerm) {
+        Vec s0 = Ops::zero(), c0 = Ops::zero();
+        Vec s1 = Ops::zero(), c1 = Ops::zero();
+        size_t i = 0;
+        for (; i + 2 * WIDTH <= count; i += 2 * WIDTH) {
+            kahanAdd(s0, c0, vecTerm(i));
+            kahanAdd(s1, c1, vecTerm(i + WIDTH));
+        }
+        for (; i + WIDTH <= count; i += WIDTH) {
+            kahanAdd(s0, c0, vecTerm(i));
+        }
+        
+        double lanes[4 * WIDTH];
+        Ops::store(lanes, s0);
+        Ops::store(lanes + WIDTH, s1);
+        Ops::store(lanes + 2 * WIDTH, c0);
+        Ops::store(lanes + 3 * WIDTH, c1);
+        
+        double total = 0.0, compensation = 0.0;
+        for (size_t lane = 0; lane < 2 * WIDTH; ++lane) {
+            kahanAddScalar(total, compensation, lanes[lane]);
+        }
+        for (size_t lane = 2 * WIDTH; lane < 4 * WIDTH; ++lane) {
+            kahanAddScalar(total, compensation, -lanes[lane]);
+        }
+        for (; i < count; ++i) {
+            kahanAddScalar(total, compensation, scalarTerm(i));
+        }
+        return total - compensation;
+    }
+};
+
+template<typename Ops>
+KernelTable makeKernelTable() {
+    using K = SimdKernels<Ops>;
+    return KernelTable{
+        &K::circleAreas, &K::circlePerimeters, &K::rectangleAreas, &K::rectanglePerimeters,
+        &K::sum, &K::sumCircleAreas, &K::sumCirclePerimeters, &K::sumRectangleAreas, &K::sumRectanglePerimeters
+    };
+}
+
+} // namespace
+
+} // namespace ShapeKernels
+
+#endif // SHAPE_KERNELS_SIMD_H
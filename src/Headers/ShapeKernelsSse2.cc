@@ -0,0 +1,39 @@
+// ============================================================================
+// FILE: shape_kernels_sse2.cc - SSE2 kernels (compiled with -msse2)
+// ============================================================================
+#include "ShapeKernelsSimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#ifndef __SSE2__
+#error "ShapeKernelsSse2.cc must be compiled with -msse2"
+#endif
+
+#include <immintrin.h>
+
+namespace ShapeKernels {
+
+namespace {
+
+struct Sse2Ops {
+    using Vec = __m128d;
+    static constexpr size_t WIDTH = 2;
+    
+    static Vec load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+    static Vec set1(double x) { return _mm_set1_pd(x); }
+    static Vec zero() { return _mm_setzero_pd(); }
+    static Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+};
+
+} // namespace
+
+KernelTable sse2KernelTable() {
+    return makeKernelTable<Sse2Ops>();
+}
+
+} // namespace ShapeKernels
+
+#endif // x86
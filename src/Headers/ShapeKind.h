@@ -0,0 +1,38 @@
+// ============================================================================
+// FILE: shape_kind.h - Allocation-free shape type tags
+// ============================================================================
+#ifndef SHAPE_KIND_H
+#define SHAPE_KIND_H
+
+#include <cstddef>
+#include <string_view>
+
+// Kind of a shape as getName() would report it: a rectangle with equal sides
+// is a SQUARE, and shapes that do not report a kind of their own are OTHER.
+// Values are dense, so they can index per-kind arrays.
+enum class ShapeKind {
+    CIRCLE,
+    RECTANGLE,
+    SQUARE,
+    OTHER
+};
+
+constexpr size_t SHAPE_KIND_COUNT = 4;
+
+// Name of a kind, from static storage (same text as Shape::getName)
+constexpr std::string_view kindName(ShapeKind kind) {
+    switch (kind) {
+        case ShapeKind::CIRCLE:    return "Circle";
+        case ShapeKind::RECTANGLE: return "Rectangle";
+        case ShapeKind::SQUARE:    return "Square";
+        case ShapeKind::OTHER:     return "Shape";
+    }
+    return "Unknown";
+}
+
+// Index of a kind in a per-kind array
+constexpr size_t kindIndex(ShapeKind kind) {
+    return static_cast<size_t>(kind);
+}
+
+#endif // SHAPE_KIND_H
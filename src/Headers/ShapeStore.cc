@@ -0,0 +1,93 @@
+// ============================================================================
+// FILE: shape_store.cc
+// ============================================================================
+#include "ShapeStore.h"
+#include "Circle.h"
+#include "Rectangle.h"
+#include "ShapeKernels.h"
+#include <algorithm>
+#include <stdexcept>
+
+size_t ShapeStore::addCircle(double radius) {
+    if (radius <= 0) {
+        throw std::invalid_argument("Radius must be positive");
+    }
+    radii.push_back(radius);
+    return radii.size() - 1;
+}
+
+size_t ShapeStore::addRectangle(double width, double height) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Dimensions must be positive");
+    }
+    widths.push_back(width);
+    heights.push_back(height);
+    return widths.size() - 1;
+}
+
+void ShapeStore::reserve(size_t circles, size_t rectangles) {
+    radii.reserve(circles);
+    widths.reserve(rectangles);
+    heights.reserve(rectangles);
+}
+
+void ShapeStore::append(const ShapeStore& other) {
+    radii.insert(radii.end(), other.radii.begin(), other.radii.end());
+    widths.insert(widths.end(), other.widths.begin(), other.widths.end());
+    heights.insert(heights.end(), other.heights.begin(), other.heights.end());
+}
+
+void ShapeStore::appendColumns(const double* radii_i, size_t circles,
+                               const double* widths_i, const double* heights_i, size_t rectangles) {
+    auto notPositive = [](double value) { return value <= 0; };
+    if (std::any_of(radii_i, radii_i + circles, notPositive)) {
+        throw std::invalid_argument("Radius must be positive");
+    }
+    if (std::any_of(widths_i, widths_i + rectangles, notPositive) ||
+        std::any_of(heights_i, heights_i + rectangles, notPositive)) {
+        throw std::invalid_argument("Dimensions must be positive");
+    }
+    radii.insert(radii.end(), radii_i, radii_i + circles);
+    widths.insert(widths.end(), widths_i, widths_i + rectangles);
+    heights.insert(heights.end(), heights_i, heights_i + rectangles);
+}
+
+void ShapeStore::clear() {
+    radii.clear();
+    widths.clear();
+    heights.clear();
+}
+
+double ShapeStore::totalArea() const {
+    return view().totalArea();
+}
+
+double ShapeStore::totalPerimeter() const {
+    return view().totalPerimeter();
+}
+
+double ShapeStore::largestPerimeter() const {
+    return view().largestPerimeter();
+}
+
+// Compensated SIMD sums over the columns, see ShapeKernels.h for the accuracy bound
+double ShapeStoreView::totalArea() const {
+    return ShapeKernels::sumCircleAreas(radii, circles)
+         + ShapeKernels::sumRectangleAreas(widths, heights, rectangles);
+}
+
+double ShapeStoreView::totalPerimeter() const {
+    return ShapeKernels::sumCirclePerimeters(radii, circles)
+         + ShapeKernels::sumRectanglePerimeters(widths, heights, rectangles);
+}
+
+double ShapeStoreView::largestPerimeter() const {
+    double largest = 0.0;
+    if (circles > 0) {
+        largest = Circle::calculatePerimeter(*std::max_element(radii, radii + circles));
+    }
+    for (size_t i = 0; i < rectangles; ++i) {
+        largest = std::max(largest, Rectangle::calculatePerimeter(widths[i], heights[i]));
+    }
+    return largest;
+}
@@ -0,0 +1,97 @@
+// ============================================================================
+// FILE: shape_store.h - Data-oriented storage, one contiguous column per field
+// ============================================================================
+#ifndef SHAPE_STORE_H
+#define SHAPE_STORE_H
+
+#include <vector>
+#include <cstddef>
+
+// Borrowed read-only columns in ShapeStore's layout: a store's own, or a
+// mapped ShapeFile's read in place with nothing copied. Valid only while the
+// owner lives. The values are not checked, so the owner answers for them.
+class ShapeStoreView {
+public:
+    ShapeStoreView() = default;
+    ShapeStoreView(const double* radii_i, size_t circles_i,
+                   const double* widths_i, const double* heights_i, size_t rectangles_i)
+        : radii(radii_i), widths(widths_i), heights(heights_i), circles(circles_i), rectangles(rectangles_i) {}
+
+    // Sizes
+    size_t circleCount() const { return circles; }
+    size_t rectangleCount() const { return rectangles; }
+    size_t size() const { return circles + rectangles; }
+    bool empty() const { return size() == 0; }
+
+    // Columns, rectangle row i is (getWidths()[i], getHeights()[i])
+    const double* getRadii() const { return radii; }
+    const double* getWidths() const { return widths; }
+    const double* getHeights() const { return heights; }
+
+    // Kernels over the columns, the same ones ShapeStore runs
+    double totalArea() const;
+    double totalPerimeter() const;
+    double largestPerimeter() const;  // 0 when the view is empty
+
+private:
+    const double* radii = nullptr;
+    const double* widths = nullptr;
+    const double* heights = nullptr;
+    size_t circles = 0;
+    size_t rectangles = 0;
+};
+
+// Holds many shapes without one heap object per shape: circles keep a radius
+// column, rectangles (and squares) keep width and height columns. Kernels walk
+// the columns directly, so there is no pointer chasing and no virtual call.
+class ShapeStore {
+public:
+    ShapeStore() = default;
+
+    // Add shapes, returning the row inside the shape's own column
+    // (same validation as Circle and Rectangle, throws std::invalid_argument)
+    size_t addCircle(double radius);
+    size_t addRectangle(double width, double height);
+
+    // Reserve room up front when the counts are known
+    void reserve(size_t circles, size_t rectangles);
+
+    // Copy every shape of other onto the end of this store's columns
+    void append(const ShapeStore& other);
+    
+    // Copy raw columns onto the end, e.g. straight out of a mapped ShapeFile.
+    // Same validation as addCircle/addRectangle; nothing is added if a row fails.
+    void appendColumns(const double* radii_i, size_t circles,
+                       const double* widths_i, const double* heights_i, size_t rectangles);
+    
+    // Remove every shape, keeps the allocated columns
+    void clear();
+
+    // Sizes
+    size_t circleCount() const { return radii.size(); }
+    size_t rectangleCount() const { return widths.size(); }
+    size_t size() const { return radii.size() + widths.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Read-only columns, rectangle row i is (getWidths()[i], getHeights()[i])
+    const std::vector<double>& getRadii() const { return radii; }
+    const std::vector<double>& getWidths() const { return widths; }
+    const std::vector<double>& getHeights() const { return heights; }
+
+    // Borrow the columns; any add, append or clear invalidates the view
+    ShapeStoreView view() const {
+        return ShapeStoreView(radii.data(), radii.size(), widths.data(), heights.data(), widths.size());
+    }
+
+    // Kernels over the columns
+    double totalArea() const;
+    double totalPerimeter() const;
+    double largestPerimeter() const;  // 0 when the store is empty
+
+private:
+    std::vector<double> radii;    // Circle column
+    std::vector<double> widths;   // Rectangle columns, same length
+    std::vector<double> heights;
+};
+
+#endif // SHAPE_STORE_H
@@ -0,0 +1,47 @@
+// ============================================================================
+// FILE: shape_variant.cc
+// ============================================================================
+#include "ShapeVariant.h"
+
+namespace GeometryUtils {
+
+double totalArea(const std::vector<ShapeVariant>& shapes) {
+    double total = 0.0;
+    for (const auto& shape : shapes) {
+        total += getArea(shape);
+    }
+    return total;
+}
+
+const ShapeVariant* largestPerimeter(const std::vector<ShapeVariant>& shapes) {
+    const ShapeVariant* largest = nullptr;
+    double maxPerimeter = 0.0;
+    
+    for (const auto& shape : shapes) {
+        double perimeter = getPerimeter(shape);
+        if (perimeter > maxPerimeter) {
+            maxPerimeter = perimeter;
+            largest = &shape;
+        }
+    }
+    
+    return largest;
+}
+
+KindTable groupByKind(const std::vector<ShapeVariant>& shapes) {
+    KindTable table{};
+    for (const auto& shape : shapes) {
+        table[kindIndex(getKind(shape))].add(getArea(shape), getPerimeter(shape));
+    }
+    return table;
+}
+
+ShapeSummary summarize(const std::vector<ShapeVariant>& shapes) {
+    ShapeSummary summary;
+    for (const auto& shape : shapes) {
+        summary.add(getKind(shape), getArea(shape), getPerimeter(shape));
+    }
+    return summary;
+}
+
+} // namespace GeometryUtils
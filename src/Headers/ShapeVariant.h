@@ -0,0 +1,64 @@
+// ============================================================================
+// FILE: shape_variant.h - Closed set of shapes with static dispatch
+// ============================================================================
+#ifndef SHAPE_VARIANT_H
+#define SHAPE_VARIANT_H
+
+#include <variant>
+#include <vector>
+#include <string>
+#include <string_view>
+#include "Circle.h"     // std::variant stores its alternatives by value,
+#include "Rectangle.h"  // so both definitions are needed here
+#include "GeometryUtils.h"
+
+// Every shape the program knows about, held by value. Unlike
+// std::unique_ptr<Shape>, std::visit knows the exact type at each call, so
+// the formulas below inline into the loop instead of going through the vtable.
+// Adding a shape means adding it here and to the visitors below.
+using ShapeVariant = std::variant<Circle, Rectangle>;
+
+// Overloads of the Shape interface for a variant. They live in the global
+// namespace, next to Circle, so that GeometryUtils templates find them by
+// argument-dependent lookup.
+inline double getArea(const ShapeVariant& shape) {
+    struct Visitor {
+        double operator()(const Circle& c) const { return Circle::calculateArea(c.getRadius()); }
+        double operator()(const Rectangle& r) const { return Rectangle::calculateArea(r.getWidth(), r.getHeight()); }
+    };
+    return std::visit(Visitor{}, shape);
+}
+
+inline double getPerimeter(const ShapeVariant& shape) {
+    struct Visitor {
+        double operator()(const Circle& c) const { return Circle::calculatePerimeter(c.getRadius()); }
+        double operator()(const Rectangle& r) const { return Rectangle::calculatePerimeter(r.getWidth(), r.getHeight()); }
+    };
+    return std::visit(Visitor{}, shape);
+}
+
+inline std::string getName(const ShapeVariant& shape) {
+    return std::visit([](const auto& s) { return s.getName(); }, shape);
+}
+
+inline ShapeKind getKind(const ShapeVariant& shape) {
+    struct Visitor {
+        ShapeKind operator()(const Circle&) const { return Circle::KIND; }
+        ShapeKind operator()(const Rectangle& r) const { return r.isSquare() ? ShapeKind::SQUARE : Rectangle::KIND; }
+    };
+    return std::visit(Visitor{}, shape);
+}
+
+inline std::string_view getKindName(const ShapeVariant& shape) {
+    return kindName(getKind(shape));
+}
+
+namespace GeometryUtils {
+    // Same utilities as for std::unique_ptr<Shape>, statically dispatched
+    double totalArea(const std::vector<ShapeVariant>& shapes);
+    const ShapeVariant* largestPerimeter(const std::vector<ShapeVariant>& shapes);
+    KindTable groupByKind(const std::vector<ShapeVariant>& shapes);
+    ShapeSummary summarize(const std::vector<ShapeVariant>& shapes);
+}
+
+#endif // SHAPE_VARIANT_H
@@ -0,0 +1,163 @@
+// ============================================================================
+// FILE: slab_pool.cc
+// ============================================================================
+#include "SlabPool.h"
+#include <algorithm>
+#include <new>
+
+namespace {
+// Which cache slots live pools hold, and how often each was handed out
+std::mutex slotMutex;
+bool slotInUse[SlabPool::MAX_POOLS];
+std::uint64_t slotGeneration[SlabPool::MAX_POOLS];
+
+// Free blocks hold a free-list link, and every block in a slab must stay aligned
+size_t roundUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+}
+
+SlabPool::SlabPool(size_t blockSize_i, size_t alignment_i, size_t blocksPerSlab_i)
+    : blockSize(roundUp(std::max(blockSize_i, sizeof(FreeBlock)), std::max(alignment_i, alignof(FreeBlock)))),
+      alignment(std::max(alignment_i, alignof(FreeBlock))),
+      blocksPerSlab(blocksPerSlab_i > 0 ? blocksPerSlab_i : 1) {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    for (size_t slot = 0; slot < MAX_POOLS; ++slot) {
+        if (!slotInUse[slot]) {
+            slotInUse[slot] = true;
+            cacheSlot = slot;
+            cacheGeneration = ++slotGeneration[slot];
+            break;
+        }
+    }
+}
+
+SlabPool::~SlabPool() {
+    if (cacheSlot < MAX_POOLS) {
+        // Caches still bound to this pool now have a stale generation: exiting
+        // threads skip them and the slot's next owner drops them
+        std::lock_guard<std::mutex> lock(slotMutex);
+        ++slotGeneration[cacheSlot];
+        slotInUse[cacheSlot] = false;
+    }
+    for (void* slab : slabs) {
+        ::operator delete(slab, std::align_val_t(alignment));
+    }
+}
+
+void* SlabPool::allocate() {
+    ThreadCache* local = cache();
+    if (!local) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return takeOne();
+    }
+    if (!local->head) {
+        local->head = takeBatch(CACHE_BATCH, local->count);
+    }
+    FreeBlock* block = local->head;
+    local->head = block->next;
+    --local->count;
+    return block;
+}
+
+void SlabPool::deallocate(void* block) {
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    ThreadCache* local = cache();
+    if (!local) {
+        std::lock_guard<std::mutex> lock(mutex);
+        freed->next = freeList;
+        freeList = freed;
+        return;
+    }
+    freed->next = local->head;
+    local->head = freed;
+    if (++local->count < 2 * CACHE_BATCH) return;
+    
+    // Keep one batch for the next allocations, give the other back
+    FreeBlock* last = local->head;
+    for (size_t i = 1; i < CACHE_BATCH; ++i) {
+        last = last->next;
+    }
+    FreeBlock* first = local->head;
+    local->head = last->next;
+    local->count -= CACHE_BATCH;
+    returnBatch(first, last, CACHE_BATCH);
+}
+
+void SlabPool::setThreadCaching(bool enabled) {
+    threadCaching.store(enabled, std::memory_order_relaxed);
+}
+
+size_t SlabPool::getSlabCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slabs.size();
+}
+
+SlabPool::ThreadCache::~ThreadCache() {
+    if (!owner || !head) return;
+    // Held across the return so the owner cannot be destroyed half way
+    std::lock_guard<std::mutex> lock(slotMutex);
+    if (slotGeneration[slot] != generation) return;
+    FreeBlock* last = head;
+    while (last->next) last = last->next;
+    owner->returnBatch(head, last, count);
+}
+
+SlabPool::ThreadCache* SlabPool::cache() {
+    if (cacheSlot >= MAX_POOLS || !isThreadCaching()) return nullptr;
+    thread_local ThreadCache caches[MAX_POOLS];
+    ThreadCache& local = caches[cacheSlot];
+    if (local.generation != cacheGeneration) {
+        // Left by an earlier pool in this slot; its blocks went with its slabs
+        local.owner = this;
+        local.generation = cacheGeneration;
+        local.slot = cacheSlot;
+        local.head = nullptr;
+        local.count = 0;
+    }
+    return &local;
+}
+
+SlabPool::FreeBlock* SlabPool::takeBatch(size_t count, size_t& taken) {
+    std::lock_guard<std::mutex> lock(mutex);
+    FreeBlock* first = takeOne();  // Out of memory here is the caller's bad_alloc
+    FreeBlock* last = first;
+    taken = 1;
+    for (; taken < count; ++taken) {
+        FreeBlock* block = nullptr;
+        try {
+            block = takeOne();
+        } catch (const std::bad_alloc&) {
+            break;  // A short batch is still a batch
+        }
+        last->next = block;
+        last = block;
+    }
+    last->next = nullptr;
+    return first;
+}
+
+void SlabPool::returnBatch(FreeBlock* first, FreeBlock* last, size_t count) {
+    if (count == 0) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    last->next = freeList;
+    freeList = first;
+}
+
+SlabPool::FreeBlock* SlabPool::takeOne() {
+    if (freeList) {
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        return block;
+    }
+    if (bump == bumpEnd) {
+        slabs.reserve(slabs.size() + 1);  // So recording the slab cannot throw after it is allocated
+        void* slab = ::operator new(blockSize * blocksPerSlab, std::align_val_t(alignment));
+        slabs.push_back(slab);
+        bump = static_cast<char*>(slab);
+        bumpEnd = bump + blockSize * blocksPerSlab;
+    }
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(bump);
+    bump += blockSize;
+    return block;
+}
@@ -0,0 +1,87 @@
+// ============================================================================
+// FILE: slab_pool.h - Fixed-size block allocator with per-thread caches
+// ============================================================================
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Hands out blocks of one size carved from large slabs. A new block is a
+// pointer bump inside the current slab; freed blocks go on a free list and are
+// reused first, so objects of one type stay packed together. Slabs are kept
+// until the pool is destroyed.
+//
+// With thread caching on (the default) each thread keeps a small private free
+// list and only takes the pool's lock once per batch of blocks. Up to MAX_POOLS
+// live pools get caches; a destroyed pool frees its cache slot for the next
+// one, and the caches other threads still hold for it are dropped unused, so a
+// pool may be destroyed once no thread is using it any more.
+class SlabPool {
+public:
+    SlabPool(size_t blockSize, size_t alignment, size_t blocksPerSlab = 4096);
+    ~SlabPool();
+    
+    // A pool owns its slabs, it cannot be copied
+    SlabPool(const SlabPool& other) = delete;
+    SlabPool& operator=(const SlabPool& other) = delete;
+    
+    // Get one block; throws std::bad_alloc if a new slab cannot be allocated
+    void* allocate();
+    
+    // Return a block that came from allocate() on this pool (any thread)
+    void deallocate(void* block);
+    
+    // Turn the per-thread caches on or off; blocks already cached stay valid
+    void setThreadCaching(bool enabled);
+    bool isThreadCaching() const { return threadCaching.load(std::memory_order_relaxed); }
+    static constexpr size_t MAX_POOLS = 16;  // Live pools that can have thread caches
+    
+    // Statistics
+    size_t getBlockSize() const { return blockSize; }
+    size_t getSlabCount() const;
+    
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+    
+    // Private free list of one thread for one pool
+    struct ThreadCache {
+        SlabPool* owner = nullptr;
+        std::uint64_t generation = 0;    // Owner's cacheGeneration; stale once the owner is destroyed
+        size_t slot = 0;
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+        ~ThreadCache();  // Gives the blocks back when the thread exits, if the owner still lives
+    };
+    
+    static constexpr size_t CACHE_BATCH = 32;  // Blocks moved per lock
+    
+    ThreadCache* cache();
+    
+    // Take or return up to count blocks under the lock
+    FreeBlock* takeBatch(size_t count, size_t& taken);
+    void returnBatch(FreeBlock* first, FreeBlock* last, size_t count);
+    
+    // Next block from the free list or the current slab, lock held
+    FreeBlock* takeOne();
+    
+    const size_t blockSize;
+    const size_t alignment;
+    const size_t blocksPerSlab;
+    size_t cacheSlot = MAX_POOLS;        // Index of this pool's cache in every thread, or MAX_POOLS
+    std::uint64_t cacheGeneration = 0;   // Tells this pool's caches from those of earlier slot owners
+    std::atomic<bool> threadCaching{true};
+    
+    mutable std::mutex mutex;            // Guards the fields below
+    FreeBlock* freeList = nullptr;
+    char* bump = nullptr;                // Next unused byte of the newest slab
+    char* bumpEnd = nullptr;
+    std::vector<void*> slabs;
+};
+
+#endif // SLAB_POOL_H
@@ -0,0 +1,99 @@
+// ============================================================================
+// FILE: thread_pool.cc
+// ============================================================================
+#include "ThreadPool.h"
+
+namespace {
+// Set while a thread is running loop bodies, so nested loops do not wait on themselves
+thread_local bool insideLoop = false;
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = 1;  // hardware_concurrency() may not know
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count_i, const std::function<void(size_t)>& body_i) {
+    if (count_i == 0) return;
+    if (workers.empty() || insideLoop || count_i == 1) {
+        for (size_t i = 0; i < count_i; ++i) {
+            body_i(i);
+        }
+        return;
+    }
+    
+    std::lock_guard<std::mutex> loopLock(loopMutex);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        body = &body_i;
+        count = count_i;
+        next.store(0);
+        failure = nullptr;
+        busyWorkers = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+    
+    runIndices();
+    
+    std::unique_lock<std::mutex> lock(stateMutex);
+    done.wait(lock, [this] { return busyWorkers == 0; });
+    body = nullptr;
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::workerLoop() {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        
+        runIndices();
+        
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (--busyWorkers == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runIndices() {
+    insideLoop = true;
+    for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+        try {
+            (*body)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!failure) failure = std::current_exception();
+            next.store(count);  // Hand out nothing more
+        }
+    }
+    insideLoop = false;
+}
@@ -0,0 +1,61 @@
+// ============================================================================
+// FILE: thread_pool.h - Reusable worker threads for data-parallel loops
+// ============================================================================
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads are started once and parked between loops, so a parallel loop costs
+// a wake-up instead of a thread creation. The calling thread works too.
+class ThreadPool {
+public:
+    // threads counts the caller, so ThreadPool(1) runs everything inline
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+    
+    // A pool owns threads, it cannot be copied
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+    
+    // Number of threads a loop runs on, caller included
+    size_t size() const { return workers.size() + 1; }
+    
+    // Call body(i) for every i in [0, count) and wait for all of them. Indices are
+    // handed out one at a time, so uneven work balances. The first exception
+    // thrown stops the loop early and is rethrown here. Called from inside a
+    // body, the inner loop runs serially on that thread.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+    
+    // Process-wide pool sized to the machine, created on first use
+    static ThreadPool& shared();
+    
+private:
+    // Worker thread main loop
+    void workerLoop();
+    
+    // Take indices of the current loop until none are left
+    void runIndices();
+    
+    std::vector<std::thread> workers;
+    std::mutex loopMutex;                    // One parallelFor at a time
+    std::mutex stateMutex;                   // Guards the fields below
+    std::condition_variable wake;            // Workers wait for a new loop
+    std::condition_variable done;            // Caller waits for workers to finish
+    const std::function<void(size_t)>* body = nullptr;
+    size_t count = 0;
+    size_t generation = 0;                   // Bumped once per loop
+    size_t busyWorkers = 0;                  // Workers still inside the current loop
+    bool stopping = false;
+    std::atomic<size_t> next{0};             // Next index to hand out
+    std::exception_ptr failure;
+};
+
+#endif // THREAD_POOL_H
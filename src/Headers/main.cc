@@ -11,6 +11,10 @@
 #include "Rectangle.h"
 #include "ShapeFactory.h"
 #include "GeometryUtils.h"
+#include "ShapeStore.h"
+#include "ShapeVariant.h"
+#include "PositionedShape.h"
+#include "ShapeBvh.h"
 
 void demonstratePolymorphism() {
     std::cout << "\n=== POLYMORPHISM DEMO ===" << std::endl;
@@ -69,6 +73,77 @@ void demonstrateUtilities() {
     // Using template function
     double avg = GeometryUtils::averageArea(shapes);
     std::cout << "Average area: " << avg << std::endl;
+    
+    // Per-kind totals in one pass, names come from static storage
+    GeometryUtils::KindTable byKind = GeometryUtils::groupByKind(shapes);
+    for (ShapeKind kind : {ShapeKind::CIRCLE, ShapeKind::RECTANGLE, ShapeKind::SQUARE}) {
+        const GeometryUtils::KindStats& stats = byKind[kindIndex(kind)];
+        std::cout << kindName(kind) << ": " << stats.count << " shape(s), area "
+                  << stats.totalArea << ", largest perimeter " << stats.maxPerimeter << std::endl;
+    }
+    
+    // Or everything at once
+    GeometryUtils::ShapeSummary summary = GeometryUtils::summarize(shapes);
+    std::cout << "Summary: " << summary.count << " shapes, area " << summary.minArea << " to " << summary.maxArea
+              << ", variance " << summary.areaVariance() << ", squares " << summary.squareCount() << std::endl;
+}
+
+void demonstrateShapeStore() {
+    std::cout << "\n=== DATA-ORIENTED STORE DEMO ===" << std::endl;
+    
+    // Same shapes as the utilities demo, but stored as columns instead of objects
+    ShapeStore store;
+    ShapeFactory::createShape(store, ShapeFactory::ShapeType::CIRCLE, 3.0);
+    ShapeFactory::createFromDescription(store, "rectangle 4.0 5.0");
+    ShapeFactory::createShape(store, ShapeFactory::ShapeType::CIRCLE, 6.0);
+    ShapeFactory::createShape(store, ShapeFactory::ShapeType::SQUARE, 10.0);
+    
+    std::cout << "Circles: " << store.circleCount()
+              << ", rectangles: " << store.rectangleCount() << std::endl;
+    std::cout << "Total area of all shapes: " << GeometryUtils::totalArea(store) << std::endl;
+    std::cout << "Largest perimeter: " << GeometryUtils::largestPerimeter(store) << std::endl;
+}
+
+void demonstrateVariant() {
+    std::cout << "\n=== CLOSED SET (std::variant) DEMO ===" << std::endl;
+    
+    // Shapes held by value; std::visit dispatches without a vtable
+    std::vector<ShapeVariant> shapes;
+    shapes.emplace_back(Circle(3.0));
+    shapes.emplace_back(Rectangle(4.0, 5.0));
+    shapes.emplace_back(Circle(6.0));
+    shapes.emplace_back(Rectangle(10.0, 10.0));
+    
+    std::cout << "Total area of all shapes: " << GeometryUtils::totalArea(shapes) << std::endl;
+    const ShapeVariant* largest = GeometryUtils::largestPerimeter(shapes);
+    if (largest) {
+        std::cout << "Shape with largest perimeter: " << getName(*largest) << std::endl;
+    }
+    std::cout << "Average area: " << GeometryUtils::averageArea(shapes) << std::endl;
+}
+
+void demonstrateSpatialIndex() {
+    std::cout << "\n=== SPATIAL INDEX DEMO ===" << std::endl;
+    
+    // Shapes placed by their centre
+    std::vector<PositionedShape> scene;
+    scene.emplace_back(std::make_unique<Circle>(3.0), Point{0.0, 0.0});
+    scene.emplace_back(std::make_unique<Rectangle>(4.0, 5.0), Point{10.0, 0.0});
+    scene.emplace_back(std::make_unique<Circle>(6.0), Point{20.0, 20.0});
+    scene.emplace_back(std::make_unique<Rectangle>(10.0, 10.0), Point{-20.0, 5.0});
+    
+    ShapeBvh bvh(scene);
+    std::vector<size_t> found;
+    bvh.findAtPoint(Point{1.0, 1.0}, found);
+    std::cout << "Shapes covering (1, 1): " << found.size() << std::endl;
+    
+    // Growing the circle makes it reach the rectangle next to it
+    found.clear();
+    std::cout << "Shapes touching the first circle: " << bvh.findOverlapping(0, found) << std::endl;
+    static_cast<Circle&>(*scene[0].shape).setRadius(8.5);
+    bvh.update(0);
+    found.clear();
+    std::cout << "After setRadius(8.5): " << bvh.findOverlapping(0, found) << std::endl;
 }
 
 void demonstrateConcreteClassUsage() {
@@ -105,6 +180,9 @@ int main() {
         demonstratePolymorphism();
         demonstrateFactory();
         demonstrateUtilities();
+        demonstrateShapeStore();
+        demonstrateVariant();
+        demonstrateSpatialIndex();
         demonstrateConcreteClassUsage();
         
         // Example of error handling
@@ -0,0 +1,105 @@
+// Geometry cache tests
+// Checks that cached shapes and AggregateCache give the same answers as the
+// plain computation, drop their values when a shape they cover is resized,
+// and are not disturbed by shapes they do not cover.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "CachedShape.h"
+#include "GeometryUtils.h"
+#include "ShapeFactory.h"
+#include "ThreadPool.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    std::vector<std::unique_ptr<Shape>> makeShapes(size_t count){
+        std::vector<std::unique_ptr<Shape>> shapes;
+        for (size_t i = 0; i < count; ++i){
+            if (i % 2 == 0)
+                shapes.push_back(std::make_unique<CachedCircle>(1.0 + i % 17));
+            else
+                shapes.push_back(std::make_unique<Rectangle>(1.0 + i % 5, 2.0 + i % 11));
+        }
+        return shapes;
+    }
+}
+
+int main(){
+    // Cached values match the plain shape and follow every setter, whatever the static type
+    CachedCircle circle(2.0);
+    check(circle.getArea() == Circle(2.0).getArea() && circle.getPerimeter() == Circle(2.0).getPerimeter(),
+          "cached circle matches Circle");
+    Circle& asCircle = circle;
+    asCircle.setRadius(3.0);
+    check(circle.getArea() == Circle(3.0).getArea() && circle.getPerimeter() == Circle(3.0).getPerimeter(),
+          "setRadius through Circle& drops the cache");
+    CachedRectangle rectangle(2.0, 5.0);
+    rectangle.getArea();
+    static_cast<Rectangle&>(rectangle).setDimensions(4.0, 4.0);
+    check(rectangle.getArea() == 16.0 && rectangle.getPerimeter() == 16.0 && rectangle.getKind() == ShapeKind::SQUARE,
+          "setDimensions drops the cache");
+    CachedRectangle copy = rectangle;
+    copy.setDimensions(1.0, 2.0);
+    check(copy.getArea() == 2.0 && rectangle.getArea() == 16.0, "a copy caches on its own");
+
+    // Each shape counts its own changes
+    std::uint64_t before = circle.getGeometryVersion();
+    Circle other(1.0);
+    other.setRadius(2.0);
+    check(circle.getGeometryVersion() == before, "another shape's change moved this version");
+    circle.setRadius(4.0);
+    check(circle.getGeometryVersion() != before, "setRadius does not move the version");
+
+    // The factory hands out cached shapes only while caching is on
+    ShapeFactory::setGeometryCaching(true);
+    std::unique_ptr<Shape> cached = ShapeFactory::createFromDescription("circle 2");
+    ShapeFactory::setGeometryCaching(false);
+    std::unique_ptr<Shape> plain = ShapeFactory::createFromDescription("circle 2");
+    check(dynamic_cast<CachedCircle*>(cached.get()) != nullptr, "factory with caching on");
+    check(dynamic_cast<CachedCircle*>(plain.get()) == nullptr, "factory with caching off");
+
+    // AggregateCache walks again only when one of its shapes or its size changed
+    std::vector<std::unique_ptr<Shape>> shapes = makeShapes(5000);
+    std::vector<std::unique_ptr<Shape>> elsewhere = makeShapes(10);
+    GeometryUtils::AggregateCache aggregates(shapes);
+    check(aggregates.isStale(), "a new cache is stale");
+    check(aggregates.totalArea() == GeometryUtils::totalArea(shapes), "cached total area");
+    check(aggregates.largestPerimeter() == GeometryUtils::largestPerimeter(shapes), "cached largest perimeter");
+    check(!aggregates.isStale(), "queried cache is fresh");
+
+    static_cast<Circle&>(*elsewhere[0]).setRadius(100.0);
+    check(!aggregates.isStale(), "a shape outside the collection made the cache stale");
+
+    static_cast<Rectangle&>(*shapes[3]).setDimensions(500.0, 1.0);
+    check(aggregates.isStale(), "resizing a plain shape in the collection leaves the cache fresh");
+    check(aggregates.largestPerimeter() == shapes[3].get(), "largest perimeter after a resize");
+    check(aggregates.totalArea() == GeometryUtils::totalArea(shapes), "total area after a resize");
+
+    shapes.push_back(std::make_unique<Circle>(1000.0));
+    check(aggregates.isStale() && aggregates.largestPerimeter() == shapes.back().get(), "appending is noticed");
+
+    // Replacing an element changes no version, so it needs invalidate()
+    shapes[0] = std::make_unique<Circle>(2000.0);
+    aggregates.invalidate();
+    check(aggregates.largestPerimeter() == shapes[0].get(), "invalidate after replacing an element");
+
+    // Cached shapes can be read from several threads at once
+    std::vector<std::unique_ptr<Shape>> fresh = makeShapes(20000);
+    ThreadPool pool(4);
+    double parallel = GeometryUtils::parallelTotalArea(fresh, pool);
+    check(parallel == GeometryUtils::parallelTotalArea(fresh, pool), "parallel reads of cached shapes");
+    std::vector<std::thread> readers;
+    std::vector<double> totals(4);
+    for (size_t t = 0; t < totals.size(); ++t)
+        readers.emplace_back([&fresh, &totals, t]{ totals[t] = GeometryUtils::totalArea(fresh); });
+    for (auto& reader : readers) reader.join();
+    check(totals[0] == totals[1] && totals[1] == totals[2] && totals[2] == totals[3], "concurrent cache fills agree");
+    return test::finish("geometry_cache_test");
+}
@@ -0,0 +1,105 @@
+// Inline inventory tests
+// Checks that an InlineInventory keeps its first N items inline, spills all of
+// them to the heap past N in order, moves back inline once it drops to N / 2,
+// and that copies, moves and rendering see the same items wherever they live.
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "inline_inventory.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    using Small = InlineInventory<4>;
+
+    // The inventory's items in index order
+    std::vector<std::string> itemsOf(const Small& inventory_i){
+        return std::vector<std::string>(inventory_i.begin(), inventory_i.end());
+    }
+
+    // Every way of reading the items agrees with expected
+    bool holds(const Small& inventory_i, const std::vector<std::string>& expected_i){
+        bool same = itemsOf(inventory_i) == expected_i && inventory_i.getItemCount() == static_cast<int>(expected_i.size());
+        for (size_t i = 0; i < expected_i.size(); ++i){
+            int index = static_cast<int>(i);
+            same = same && inventory_i[index] == expected_i[i] && inventory_i.itemAt(index) == expected_i[i]
+                   && inventory_i.tryGetItem(index) == std::string_view(expected_i[i]);
+        }
+        int count = inventory_i.getItemCount();
+        return same && inventory_i[count] == "Index out of bounds" && !inventory_i.tryGetItem(count);
+    }
+
+    // What running action prints
+    template<typename Action>
+    std::string printed(Action action_i){
+        std::ostringstream out;
+        std::streambuf* previous = std::cout.rdbuf(out.rdbuf());
+        action_i();
+        std::cout.rdbuf(previous);
+        return out.str();
+    }
+}
+
+int main(){
+    ItemRegistry registry;
+    Small bag(10, registry);
+    bag += "a"; bag += "b"; bag += "c"; bag += "d";
+    check(bag.isInline() && holds(bag, {"a", "b", "c", "d"}), "N items stay inline");
+
+    // The item past N spills every item to the heap, order kept
+    bag += "e";
+    check(!bag.isInline() && holds(bag, {"a", "b", "c", "d", "e"}), "spill keeps the items in order");
+    bag += registry.intern("f");
+    check(holds(bag, {"a", "b", "c", "d", "e", "f"}), "adding by id after the spill");
+
+    // Removing keeps order and only returns inline at N / 2, so the boundary does not thrash
+    bag -= "b"; bag -= "e"; bag -= "f";
+    check(!bag.isInline() && holds(bag, {"a", "c", "d"}), "stays on the heap just below N");
+    bag += "g";
+    check(!bag.isInline() && holds(bag, {"a", "c", "d", "g"}), "adding back to N stays on the heap");
+    bag -= "a"; bag -= registry.intern("g");
+    check(bag.isInline() && holds(bag, {"c", "d"}), "returns inline at N / 2");
+    bag += "h"; bag += "i";
+    check(bag.isInline() && holds(bag, {"c", "d", "h", "i"}), "inline again up to N");
+
+    // Misses and a full inventory print and change nothing
+    Small tiny(2, registry);
+    tiny += "x"; tiny += "y";
+    std::string full = printed([&tiny]{ tiny += "z"; });
+    std::string missing = printed([&tiny]{ tiny -= "never"; tiny -= "a"; });
+    check(full == "Inventory is full, cannot add z\n" && holds(tiny, {"x", "y"}), "a full inventory adds nothing");
+    check(missing == "Item never not found in inventory\nItem a not found in inventory\n" && holds(tiny, {"x", "y"}),
+          "removing a missing item changes nothing");
+
+    // Copies are independent, whether the source is inline or spilled
+    Small inlineCopy = bag;
+    inlineCopy -= "c";
+    check(holds(bag, {"c", "d", "h", "i"}) && holds(inlineCopy, {"d", "h", "i"}), "inline copy is independent");
+    bag += "j";
+    Small heapCopy = bag;
+    heapCopy += "k";
+    check(holds(bag, {"c", "d", "h", "i", "j"}) && holds(heapCopy, {"c", "d", "h", "i", "j", "k"})
+          && !heapCopy.isInline(), "spilled copy is independent");
+
+    // Moves take the items and leave the source empty and inline
+    Small moved = std::move(heapCopy);
+    check(holds(moved, {"c", "d", "h", "i", "j", "k"}) && heapCopy.getItemCount() == 0 && heapCopy.isInline(),
+          "move from a spilled inventory");
+    Small target(10, registry);
+    target += "old";
+    target = std::move(inlineCopy);
+    check(holds(target, {"d", "h", "i"}) && inlineCopy.getItemCount() == 0, "move assignment from an inline inventory");
+    heapCopy += "l";
+    check(holds(heapCopy, {"l"}), "a moved-from inventory can be reused");
+
+    // Rendering reads the same items from either storage
+    RenderBuffer out;
+    target.render(out, RenderFormat::TEXT, "Bag");
+    moved.render(out, RenderFormat::CSV, "Big");
+    check(out.view() == "Bag: [ d, h, i ]\nBig,c,d,h,i,j,k\n", "render");
+    return test::finish("inline_inventory_test");
+}
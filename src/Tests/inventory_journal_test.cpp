@@ -0,0 +1,129 @@
+// Inventory journal tests
+// Replays a journaled inventory's changes into replicas with other policies
+// and other registries and checks they hold the same items in the same order,
+// that overlapping deltas are skipped, and that gaps and mismatches stop the
+// replay instead of applying changes out of order.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "inventory.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    // Small deterministic generator, so a failure replays the same way
+    struct Lcg{
+        std::uint64_t state;
+
+        int next(int bound_i){
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<int>((state >> 33) % static_cast<std::uint64_t>(bound_i));
+        }
+    };
+
+    // The inventory's items in index order
+    std::vector<std::string> itemsOf(const Inventory& inventory_i){
+        return std::vector<std::string>(inventory_i.begin(), inventory_i.end());
+    }
+
+    // Send everything replica_i has not applied yet, false if the sender cannot or the replica refuses
+    bool sync(const Inventory& sender_i, Inventory& replica_i){
+        std::vector<InventoryDelta> deltas;
+        return sender_i.deltasSince(replica_i.getJournalSequence(), deltas) && replica_i.applyDeltas(deltas);
+    }
+
+    // Random changes to sender, synced into a replica of each policy every few steps
+    void replay(RemovalPolicy senderPolicy_i, const std::vector<RemovalPolicy>& replicaPolicies_i, const std::string& label_i){
+        ItemRegistry senderNames;
+        ItemRegistry replicaNames;
+        replicaNames.intern("padding"); // So the replicas' ids differ from the sender's
+        Inventory sender(500, senderPolicy_i, senderNames);
+        sender.enableJournal();
+        std::vector<Inventory> replicas;
+        replicas.reserve(replicaPolicies_i.size());
+        for (RemovalPolicy policy : replicaPolicies_i)
+            replicas.emplace_back(500, policy, replicaNames);
+
+        bool synced = true, same = true;
+        Lcg random{11};
+        for (int step = 0; step < 3000; ++step){
+            std::string name = "item" + std::to_string(random.next(10));
+            int roll = random.next(10);
+            if (roll < 5 && sender.getItemCount() < 200)
+                sender.addItems(std::vector<std::string>{name});
+            else if (roll < 9)
+                sender.removeItems(std::vector<std::string>{name});
+            else
+                sender.removeItems(std::vector<std::string>{name, "item1", name});
+
+            if (step % 7 == 0 || step == 2999){
+                for (Inventory& replica : replicas){
+                    synced = synced && sync(sender, replica);
+                    same = same && itemsOf(replica) == itemsOf(sender) && replica.getJournalSequence() == sender.getJournalSequence();
+                }
+                sender.compactJournal(sender.getJournalSequence()); // Every replica has applied everything
+            }
+        }
+        check(synced, label_i + ": a replica refused the sender's deltas");
+        check(same, label_i + ": a replica differs from the sender");
+    }
+}
+
+int main(){
+    // Every supported pairing of sender and receiver policies ends up identical
+    replay(RemovalPolicy::LINEAR, {RemovalPolicy::LINEAR, RemovalPolicy::TOMBSTONE}, "LINEAR sender");
+    replay(RemovalPolicy::SWAP_AND_POP, {RemovalPolicy::SWAP_AND_POP, RemovalPolicy::LINEAR}, "SWAP_AND_POP sender");
+    replay(RemovalPolicy::TOMBSTONE, {RemovalPolicy::TOMBSTONE, RemovalPolicy::LINEAR}, "TOMBSTONE sender");
+
+    // Deltas carry names, ops and live indices
+    ItemRegistry registry;
+    Inventory sender(20, RemovalPolicy::SWAP_AND_POP, registry);
+    check(!sender.hasJournal() && sender.getJournalSequence() == 0, "a new inventory has no journal");
+    sender.enableJournal();
+    sender.addItems({"a", "b", "c"});
+    sender.removeItems({"a"});
+    std::vector<InventoryDelta> deltas;
+    check(sender.deltasSince(0, deltas) && deltas.size() == 4, "every change is recorded");
+    check(deltas[0].op == DeltaOp::ADD && deltas[0].name == "a" && deltas[0].index == 0 && deltas[0].sequence == 1
+          && deltas[2].index == 2 && deltas[3].op == DeltaOp::MOVE && deltas[3].name == "a" && deltas[3].index == 0,
+          "delta contents");
+
+    // Applying the same deltas again is skipped as an overlap
+    ItemRegistry otherNames;
+    Inventory replica(20, RemovalPolicy::SWAP_AND_POP, otherNames);
+    check(replica.applyDeltas(deltas) && replica.applyDeltas(deltas), "overlapping deltas are accepted");
+    check(itemsOf(replica) == std::vector<std::string>({"c", "b"}) && replica.getJournalSequence() == 4, "overlap applied once");
+
+    // Compacted deltas cannot be sent, the receiver needs everything again
+    sender.addItems({"d"});
+    sender.compactJournal(sender.getJournalSequence());
+    sender.addItems({"e"});
+    std::vector<InventoryDelta> late;
+    check(!sender.deltasSince(3, late) && late.empty(), "deltas compacted away");
+    check(sender.deltasSince(5, late) && late.size() == 1 && late[0].name == "e", "deltas after the compacted point");
+
+    // A gap stops the replay before applying anything past it
+    check(!replica.applyDeltas(late) && replica.getJournalSequence() == 4 && itemsOf(replica).size() == 2,
+          "a gap is refused");
+
+    // Changes while the journal is off still count, so an old receiver sees a gap
+    sender.disableJournal();
+    sender.addItems({"f"});
+    sender.enableJournal();
+    sender.addItems({"g"});
+    std::vector<InventoryDelta> afterPause;
+    check(sender.getJournalSequence() == 8 && !sender.deltasSince(6, afterPause), "changes while off leave a gap");
+    check(sender.deltasSince(7, afterPause) && afterPause.size() == 1 && afterPause[0].sequence == 8, "deltas after re-enabling");
+    check(sender.deltasSince(8, afterPause) && afterPause.size() == 1 && !sender.deltasSince(9, afterPause),
+          "an up-to-date or future receiver");
+
+    // A receiver that does not hold what the sender removed refuses the delta
+    Inventory stranger(20, RemovalPolicy::LINEAR, otherNames);
+    std::vector<InventoryDelta> removal{InventoryDelta{1, registry.intern("z"), "z", 0, DeltaOp::REMOVE}};
+    check(!stranger.applyDeltas(removal) && stranger.getJournalSequence() == 0, "removing a missing item is refused");
+    std::vector<InventoryDelta> misplaced{InventoryDelta{1, registry.intern("z"), "z", 3, DeltaOp::ADD}};
+    check(!stranger.applyDeltas(misplaced) && stranger.getItemCount() == 0, "an add at another index is refused");
+    return test::finish("inventory_journal_test");
+}
@@ -0,0 +1,154 @@
+// Inventory removal tests
+// Runs the same adds and removes under LINEAR, SWAP_AND_POP and TOMBSTONE
+// against a plain vector and checks indexed access, iteration, counts and
+// compaction agree with it, including while TOMBSTONE holes are pending.
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "inventory.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    const int NAMES = 12;
+
+    // Small deterministic generator, so a failure replays the same way
+    struct Lcg{
+        std::uint64_t state;
+
+        int next(int bound_i){
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<int>((state >> 33) % static_cast<std::uint64_t>(bound_i));
+        }
+    };
+
+    std::string nameOf(int i_i){
+        return "item" + std::to_string(i_i);
+    }
+
+    // The inventory's items in index order, read through operator[]
+    std::vector<std::string> byIndex(const Inventory& inventory_i){
+        std::vector<std::string> names;
+        for (int i = 0; i < inventory_i.getItemCount(); ++i)
+            names.push_back(inventory_i[i]);
+        return names;
+    }
+
+    // Every way of reading the items gives the same names in the same order
+    bool readsAgree(const Inventory& inventory_i){
+        std::vector<std::string> names = byIndex(inventory_i);
+        std::vector<std::string> iterated(inventory_i.begin(), inventory_i.end());
+        bool same = names == iterated;
+        for (int i = 0; i < inventory_i.getItemCount(); ++i){
+            std::optional<ItemId> id = inventory_i.getItemId(i);
+            same = same && inventory_i.itemAt(i) == names[i] && inventory_i.tryGetItem(i) == std::string_view(names[i])
+                   && id && inventory_i.getRegistry().name(*id) == names[i];
+        }
+        int count = inventory_i.getItemCount();
+        return same && inventory_i[count] == "Index out of bounds" && inventory_i[-1] == "Index out of bounds"
+               && !inventory_i.tryGetItem(count) && !inventory_i.getItemId(count);
+    }
+
+    // countOf matches the model for every name
+    bool countsAgree(const Inventory& inventory_i, const std::vector<std::string>& model_i){
+        bool same = true;
+        for (int n = 0; n < NAMES; ++n){
+            std::optional<ItemId> id = inventory_i.getRegistry().lookup(nameOf(n));
+            int held = static_cast<int>(std::count(model_i.begin(), model_i.end(), nameOf(n)));
+            same = same && (id ? inventory_i.countOf(*id) : 0) == held;
+        }
+        return same;
+    }
+
+    // Random adds and removes, checked against a vector after every step
+    void runPolicy(RemovalPolicy policy_i, const std::string& label_i){
+        ItemRegistry registry;
+        Inventory inventory(1000, policy_i, registry);
+        std::vector<std::string> model;
+        bool keepsOrder = policy_i != RemovalPolicy::SWAP_AND_POP;
+        bool masks = true, order = true, reads = true, counts = true;
+
+        Lcg random{7};
+        for (int step = 0; step < 4000; ++step){
+            std::string name = nameOf(random.next(NAMES));
+            if (random.next(5) < 3 && model.size() < 400){
+                inventory.addItems(std::vector<std::string>{name});
+                model.push_back(name);
+            } else {
+                auto it = std::find(model.begin(), model.end(), name);
+                bool removed = inventory.removeItems(std::vector<std::string>{name})[0];
+                masks = masks && removed == (it != model.end());
+                if (it != model.end()) model.erase(it);
+            }
+
+            std::vector<std::string> held = byIndex(inventory);
+            if (keepsOrder)
+                order = order && held == model;
+            else {
+                std::vector<std::string> sortedHeld = held, sortedModel = model;
+                std::sort(sortedHeld.begin(), sortedHeld.end());
+                std::sort(sortedModel.begin(), sortedModel.end());
+                order = order && sortedHeld == sortedModel;
+            }
+            if (step % 50 == 0){
+                reads = reads && readsAgree(inventory);
+                counts = counts && countsAgree(inventory, model);
+            }
+        }
+        check(masks, label_i + ": removal reports whether the item was held");
+        check(order, label_i + (keepsOrder ? ": items or order differ from the model" : ": items differ from the model"));
+        check(reads, label_i + ": operator[], itemAt, tryGetItem, getItemId and iteration disagree");
+        check(counts, label_i + ": countOf differs from the model");
+
+        // Compacting changes no index, and ids() is the compacted order
+        std::vector<std::string> before = byIndex(inventory);
+        inventory.compact();
+        check(byIndex(inventory) == before && readsAgree(inventory), label_i + ": compact changed the items");
+        Inventory::IdSpan ids = inventory.ids();
+        bool sameIds = ids.size() == before.size();
+        for (size_t i = 0; sameIds && i < ids.size(); ++i)
+            sameIds = registry.name(ids[i]) == before[i];
+        check(sameIds, label_i + ": ids() differs from the items");
+    }
+}
+
+int main(){
+    runPolicy(RemovalPolicy::LINEAR, "LINEAR");
+    runPolicy(RemovalPolicy::SWAP_AND_POP, "SWAP_AND_POP");
+    runPolicy(RemovalPolicy::TOMBSTONE, "TOMBSTONE");
+
+    // TOMBSTONE removes the oldest copy and leaves holes that indexed access skips
+    ItemRegistry registry;
+    Inventory tombs(100, RemovalPolicy::TOMBSTONE, registry);
+    tombs.addItems({"a", "b", "a", "c", "d", "e", "f", "g", "h", "i"});
+    tombs.removeItems({"a", "c"});
+    check(byIndex(tombs) == std::vector<std::string>({"b", "a", "d", "e", "f", "g", "h", "i"}) && readsAgree(tombs),
+          "indexed access skips the holes");
+    tombs.removeItems({"d", "f"});
+    check(tombs[0] == "b" && tombs[1] == "a" && tombs[2] == "e" && tombs[3] == "g" && tombs[5] == "i"
+          && tombs.getItemCount() == 6, "indexed access after more holes");
+
+    // Removing more than half the slots compacts on its own, and later adds go to the end
+    tombs.removeItems({"b", "e", "g"});
+    tombs.addItems({"j"});
+    check(byIndex(tombs) == std::vector<std::string>({"a", "h", "i", "j"}) && readsAgree(tombs), "after automatic compaction");
+
+    // A LINEAR batch removes the same copies as removing one at a time
+    Inventory linear(100, RemovalPolicy::LINEAR, registry);
+    linear.addItems({"a", "b", "a", "c", "a", "b"});
+    std::vector<bool> mask = linear.removeItems({"a", "x", "b", "a"});
+    check(mask == std::vector<bool>({true, false, true, true}), "LINEAR batch mask");
+    check(byIndex(linear) == std::vector<std::string>({"c", "a", "b"}), "LINEAR batch keeps order");
+
+    // Switching policy with holes pending keeps the items and their order
+    tombs.removeItems({"h"});
+    tombs.setRemovalPolicy(RemovalPolicy::SWAP_AND_POP);
+    check(byIndex(tombs) == std::vector<std::string>({"a", "i", "j"}) && readsAgree(tombs), "policy switch with holes");
+    tombs.removeItems({"a"});
+    check(byIndex(tombs) == std::vector<std::string>({"j", "i"}), "SWAP_AND_POP moves the last item into the hole");
+    return test::finish("inventory_removal_test");
+}
@@ -0,0 +1,150 @@
+// Inventory snapshot tests
+// Writes a small snapshot, then damages one field at a time and checks that
+// opening the file or reading the damaged part throws std::runtime_error
+// instead of reading out of bounds.
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include "inventory.h"
+#include "inventory_snapshot.h"
+#include "test_check.h"
+
+namespace {
+    const char* PATH = "inventory_snapshot_test.snap";
+
+    // Byte offsets of the fields the tests damage, as laid out by InventorySnapshot::write
+    const size_t NAME_COUNT = 12;
+    const size_t ITEM_COUNT = 24;
+    const size_t NAME_TABLE_OFFSET = 32;
+    const size_t RECORDS_OFFSET = 48;
+    const size_t ITEMS_OFFSET = 56;
+    const size_t RECORD_FIRST_ITEM = 0;
+    const size_t RECORD_CAPACITY = 12;
+    const size_t RECORD_POLICY = 16;
+
+    using test::check;
+
+    std::vector<char> readFile(const char* path){
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const char* path, const std::vector<char>& bytes){
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    template<typename T>
+    T get(const std::vector<char>& bytes, size_t at){
+        T value;
+        std::memcpy(&value, bytes.data() + at, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void put(std::vector<char>& bytes, size_t at, T value){
+        std::memcpy(bytes.data() + at, &value, sizeof(T));
+    }
+
+    // Damage a copy of the good file, then expect opening it or reading every record to throw
+    void expectRejected(const std::vector<char>& good, const std::string& what, const std::function<void(std::vector<char>&)>& damage){
+        std::vector<char> bytes = good;
+        damage(bytes);
+        writeFile(PATH, bytes);
+        try{
+            InventorySnapshot snapshot(PATH);
+            for (size_t i = 0; i < snapshot.getInventoryCount(); ++i){
+                for (size_t item = 0; item < snapshot.getItemCount(i); ++item)
+                    snapshot.getItemName(i, item);
+                snapshot.load(i);
+            }
+            check(false, what + " was accepted");
+        }
+        catch (const std::runtime_error&){
+        }
+    }
+}
+
+int main(){
+    Inventory first(10, RemovalPolicy::SWAP_AND_POP);
+    first += "Sword";
+    first += "Shield";
+    first += "Sword";
+    Inventory second(5, RemovalPolicy::TOMBSTONE);
+    second += "Potion";
+    InventorySnapshot::write(PATH, {&first, &second});
+    std::vector<char> good = readFile(PATH);
+
+    {
+        InventorySnapshot snapshot(PATH);
+        check(snapshot.getInventoryCount() == 2, "inventory count");
+        check(snapshot.load(0).getItemCount() == 3, "first inventory round trip");
+        check(snapshot.getItemName(1, 0) == "Potion", "item name round trip");
+
+        // Concurrent loads into different registries share the id cache
+        ItemRegistry worlds[4];
+        std::vector<std::thread> threads;
+        for (ItemRegistry& world : worlds)
+            threads.emplace_back([&snapshot, &world]{
+                for (int i = 0; i < 200; ++i)
+                    snapshot.load(i % 2, world);
+            });
+        for (auto& thread : threads) thread.join();
+        check(worlds[3].lookup("Shield").has_value(), "load into another registry");
+
+        bool outOfRange = false;
+        try{
+            snapshot.getItemCount(2);
+        }
+        catch (const std::out_of_range&){
+            outOfRange = true;
+        }
+        check(outOfRange, "inventory index past the record table");
+    }
+
+    // A damaged record is only noticed when it is read, the others still load
+    std::vector<char> lazy = good;
+    put<std::uint32_t>(lazy, get<std::uint64_t>(good, RECORDS_OFFSET) + RECORD_POLICY, 7);
+    writeFile(PATH, lazy);
+    {
+        InventorySnapshot snapshot(PATH);
+        check(snapshot.load(1).getItemCount() == 1, "undamaged record of a damaged file");
+    }
+
+    std::uint64_t records = get<std::uint64_t>(good, RECORDS_OFFSET);
+    std::uint64_t itemsAt = get<std::uint64_t>(good, ITEMS_OFFSET);
+    std::uint32_t names = get<std::uint32_t>(good, NAME_COUNT);
+    std::uint64_t nameTable = get<std::uint64_t>(good, NAME_TABLE_OFFSET);
+
+    expectRejected(good, "first item past the item table", [&](std::vector<char>& bytes){
+        put<std::uint64_t>(bytes, records + RECORD_FIRST_ITEM, 0x7fffffff);
+    });
+    expectRejected(good, "item count that overflows the offset", [&](std::vector<char>& bytes){
+        put<std::uint64_t>(bytes, ITEM_COUNT, std::uint64_t(1) << 62);
+    });
+    expectRejected(good, "item name index past the name table", [&](std::vector<char>& bytes){
+        put<std::uint32_t>(bytes, itemsAt, names);
+    });
+    expectRejected(good, "name outside the string blob", [&](std::vector<char>& bytes){
+        put<std::uint32_t>(bytes, nameTable, 0xfffffff0);
+    });
+    expectRejected(good, "unknown removal policy", [&](std::vector<char>& bytes){
+        put<std::uint32_t>(bytes, records + RECORD_POLICY, 7);
+    });
+    expectRejected(good, "more items than the capacity", [&](std::vector<char>& bytes){
+        put<std::int32_t>(bytes, records + RECORD_CAPACITY, 2);
+    });
+    expectRejected(good, "truncated file", [&](std::vector<char>& bytes){
+        bytes.resize(bytes.size() - 8);
+    });
+
+    std::remove(PATH);
+    return test::finish("inventory_snapshot_test");
+}
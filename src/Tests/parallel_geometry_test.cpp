@@ -0,0 +1,84 @@
+// Parallel geometry tests
+// Runs the parallel GeometryUtils reductions on pools of one, two and four
+// threads and checks the answers are identical, agree with the serial ones,
+// and handle empty collections, null entries and partial chunks.
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "GeometryUtils.h"
+#include "ShapeStore.h"
+#include "ThreadPool.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    bool close(double a, double b){
+        return std::fabs(a - b) <= 1e-12 * std::fmax(std::fabs(a), std::fabs(b));
+    }
+}
+
+int main(){
+    // Several chunks plus a partial one, with ties for the largest perimeter and a null entry
+    const size_t COUNT = 3 * GeometryUtils::PARALLEL_CHUNK + 123;
+    std::vector<std::unique_ptr<Shape>> shapes;
+    ShapeStore store;
+    for (size_t i = 0; i < COUNT; ++i){
+        if (i % 3 == 0){
+            shapes.push_back(std::make_unique<Circle>(0.5 + i % 101));
+            store.addCircle(0.5 + i % 101);
+        } else {
+            shapes.push_back(std::make_unique<Rectangle>(1.0 + i % 7, 1.0 + i % 19));
+            store.addRectangle(1.0 + i % 7, 1.0 + i % 19);
+        }
+    }
+    shapes[GeometryUtils::PARALLEL_CHUNK + 5].reset();
+
+    ThreadPool one(1), two(2), four(4);
+    double area = GeometryUtils::parallelTotalArea(shapes, one);
+    check(area == GeometryUtils::parallelTotalArea(shapes, two) && area == GeometryUtils::parallelTotalArea(shapes, four),
+          "parallelTotalArea depends on the thread count");
+    check(close(area, GeometryUtils::totalArea(shapes)), "parallelTotalArea differs from totalArea");
+
+    // The first of several equal maxima wins, as in the serial scan
+    const Shape* largest = GeometryUtils::largestPerimeter(shapes);
+    check(GeometryUtils::parallelLargestPerimeter(shapes, one) == largest
+          && GeometryUtils::parallelLargestPerimeter(shapes, four) == largest, "parallelLargestPerimeter picks another shape");
+
+    double storeArea = GeometryUtils::parallelTotalArea(store, one);
+    check(storeArea == GeometryUtils::parallelTotalArea(store, four), "store parallelTotalArea depends on the thread count");
+    check(close(storeArea, store.totalArea()), "store parallelTotalArea differs from totalArea");
+    check(GeometryUtils::parallelLargestPerimeter(store, four) == store.largestPerimeter(),
+          "store parallelLargestPerimeter differs from largestPerimeter");
+
+    // averageArea works on any pointer-like element
+    std::vector<std::shared_ptr<Shape>> shared;
+    for (size_t i = 0; i < COUNT; ++i) shared.push_back(std::make_shared<Circle>(1.0 + i % 10));
+    double serialAverage = GeometryUtils::averageArea(shared);
+    check(GeometryUtils::parallelAverageArea(shared, one) == GeometryUtils::parallelAverageArea(shared, four),
+          "parallelAverageArea depends on the thread count");
+    check(close(GeometryUtils::parallelAverageArea(shared, two), serialAverage), "parallelAverageArea differs from averageArea");
+
+    // Empty inputs
+    std::vector<std::unique_ptr<Shape>> none;
+    ShapeStore empty;
+    check(GeometryUtils::parallelTotalArea(none, four) == 0.0 && GeometryUtils::parallelLargestPerimeter(none, four) == nullptr,
+          "empty collection");
+    check(GeometryUtils::parallelTotalArea(empty, four) == 0.0 && GeometryUtils::parallelLargestPerimeter(empty, four) == 0.0,
+          "empty store");
+    check(GeometryUtils::parallelAverageArea(std::vector<std::shared_ptr<Shape>>(), four) == 0.0, "empty average");
+
+    // The pool keeps working across many small loops
+    size_t sum = 0;
+    for (int round = 0; round < 1000; ++round){
+        std::vector<size_t> parts(7, 0);
+        four.parallelFor(parts.size(), [&parts, round](size_t i){ parts[i] = i + round; });
+        for (size_t part : parts) sum += part;
+    }
+    check(sum == 1000 * 21 + 7 * (999 * 1000 / 2), "parallelFor runs every index once per loop");
+    return test::finish("parallel_geometry_test");
+}
@@ -0,0 +1,175 @@
+// Shape file tests
+// Writes stores and scenes, reads them back in place and by copy, then damages
+// the header, a column or the file length one at a time and checks that the
+// damage is reported as std::runtime_error.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "PositionedShape.h"
+#include "ShapeFile.h"
+#include "ShapeStore.h"
+#include "test_check.h"
+
+namespace {
+    const char* PATH = "shape_file_test.bin";
+
+    // Byte offsets of the fields the tests damage, as laid out by ShapeFile::write
+    const size_t VERSION = 8;
+    const size_t SHAPE_COUNT = 24;
+    const size_t RADIUS_COLUMN_OFFSET = 80;
+    const size_t HEADER_CHECKSUM = 200;
+
+    using test::check;
+
+    std::vector<char> readFile(const char* path){
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const char* path, const std::vector<char>& bytes){
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    template<typename T>
+    T get(const std::vector<char>& bytes, size_t at){
+        T value;
+        std::memcpy(&value, bytes.data() + at, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void put(std::vector<char>& bytes, size_t at, T value){
+        std::memcpy(bytes.data() + at, &value, sizeof(T));
+    }
+
+    // True if action throws std::runtime_error
+    bool throwsRuntimeError(const std::function<void()>& action){
+        try{
+            action();
+        }
+        catch (const std::runtime_error&){
+            return true;
+        }
+        catch (...){
+            return false;
+        }
+        return false;
+    }
+
+    // Damage a copy of the good file, then expect opening it to throw
+    void expectRejected(const std::vector<char>& good, const std::string& what, const std::function<void(std::vector<char>&)>& damage){
+        std::vector<char> bytes = good;
+        damage(bytes);
+        writeFile(PATH, bytes);
+        check(throwsRuntimeError([]{ ShapeFile file(PATH); }), what + " was accepted");
+    }
+}
+
+int main(){
+    ShapeStore store;
+    for (int i = 1; i <= 1000; ++i){
+        store.addCircle(i * 0.25);
+        store.addRectangle(i * 0.5, i % 3 == 0 ? i * 0.5 : i * 0.125);
+    }
+
+    // A store round trips column for column, and the view reads the same values in place
+    ShapeFile::write(PATH, store);
+    {
+        ShapeFile file(PATH, true);
+        check(file.size() == store.size() && file.circleCount() == 1000 && file.rectangleCount() == 1000, "store counts");
+        check(!file.hasPositions() && file.getX() == nullptr, "a store has no positions");
+        check(file.verify(), "fresh file verifies");
+        ShapeStore copy;
+        file.loadInto(copy);
+        check(copy.getRadii() == store.getRadii() && copy.getWidths() == store.getWidths()
+              && copy.getHeights() == store.getHeights(), "loadInto round trip");
+        ShapeStoreView view = file.view();
+        check(view.totalArea() == store.totalArea() && view.totalPerimeter() == store.totalPerimeter()
+              && view.largestPerimeter() == store.largestPerimeter(), "view kernels match the store");
+        check(file.loadScene().size() == store.size(), "a store loads as a scene");
+    }
+
+    // A scene keeps its order, kinds and positions
+    std::vector<PositionedShape> scene;
+    scene.emplace_back(std::make_unique<Rectangle>(2.0, 2.0), Point{1.0, -1.0});
+    scene.emplace_back(std::make_unique<Circle>(3.0), Point{5.0, 6.0});
+    scene.emplace_back(std::make_unique<Rectangle>(1.0, 4.0), Point{-2.5, 0.5});
+    ShapeFile::write(PATH, scene);
+    {
+        ShapeFile file(PATH);
+        std::vector<PositionedShape> loaded = file.loadScene();
+        bool same = loaded.size() == scene.size();
+        for (size_t i = 0; same && i < scene.size(); ++i){
+            same = loaded[i].shape->getKind() == scene[i].shape->getKind()
+                   && loaded[i].shape->getArea() == scene[i].shape->getArea()
+                   && loaded[i].position.x == scene[i].position.x && loaded[i].position.y == scene[i].position.y;
+        }
+        check(same, "scene round trip");
+    }
+
+    // Empty stores are valid files
+    ShapeFile::write(PATH, ShapeStore());
+    {
+        ShapeFile file(PATH, true);
+        check(file.size() == 0 && file.view().totalArea() == 0.0, "empty store round trip");
+    }
+
+    ShapeFile::write(PATH, store);
+    std::vector<char> good = readFile(PATH);
+    std::uint64_t radii = get<std::uint64_t>(good, RADIUS_COLUMN_OFFSET);
+
+    expectRejected(good, "wrong magic", [](std::vector<char>& bytes){
+        bytes[0] = 'X';
+    });
+    expectRejected(good, "unknown version", [](std::vector<char>& bytes){
+        put<std::uint32_t>(bytes, VERSION, 99);
+    });
+    expectRejected(good, "header checksum mismatch", [](std::vector<char>& bytes){
+        put<std::uint64_t>(bytes, HEADER_CHECKSUM, get<std::uint64_t>(bytes, HEADER_CHECKSUM) ^ 1);
+    });
+    expectRejected(good, "shape count changed without its checksum", [](std::vector<char>& bytes){
+        put<std::uint64_t>(bytes, SHAPE_COUNT, 5);
+    });
+    expectRejected(good, "truncated file", [](std::vector<char>& bytes){
+        bytes.resize(bytes.size() - 64);
+    });
+    expectRejected(good, "file shorter than a header", [](std::vector<char>& bytes){
+        bytes.resize(100);
+    });
+    check(throwsRuntimeError([]{ ShapeFile file("shape_file_test.missing"); }), "a missing file was accepted");
+
+    // A damaged column passes the header check, fails verify() and is rejected when verifying on open
+    std::vector<char> damaged = good;
+    put<double>(damaged, radii + 8 * 10, 1234.5);
+    writeFile(PATH, damaged);
+    {
+        ShapeFile file(PATH);
+        check(!file.verify(), "changed radius fails verify()");
+    }
+    check(throwsRuntimeError([]{ ShapeFile file(PATH, true); }), "changed radius was accepted with verify");
+
+    // A value no shape can have is reported as a corrupt file, never as std::invalid_argument
+    put<double>(damaged, radii, -1.0);
+    writeFile(PATH, damaged);
+    {
+        ShapeFile file(PATH);
+        ShapeStore copy;
+        check(throwsRuntimeError([&file]{ file.loadScene(); }), "negative radius in loadScene");
+        check(throwsRuntimeError([&]{ file.loadInto(copy); }), "negative radius in loadInto");
+        check(copy.empty(), "a failed loadInto adds nothing");
+    }
+
+    std::remove(PATH);
+    return test::finish("shape_file_test");
+}
@@ -0,0 +1,110 @@
+// Shape kernel tests
+// Runs every kernel on every ISA this CPU supports and checks the accuracy
+// contract in ShapeKernels.h: per-shape values bit-identical to Circle and
+// Rectangle, totals within SUM_ULP_BOUND ulps of a long double reference.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "ShapeKernels.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    // Distance in representable doubles between two finite values of the same sign
+    std::int64_t ulpDistance(double a, double b){
+        std::int64_t ia, ib;
+        std::memcpy(&ia, &a, sizeof a);
+        std::memcpy(&ib, &b, sizeof b);
+        return ia > ib ? ia - ib : ib - ia;
+    }
+
+    // Reference total: compensated summation in long double, far below one double ulp
+    double referenceSum(const std::vector<double>& values){
+        long double sum = 0.0L, compensation = 0.0L;
+        for (double v : values){
+            long double y = v - compensation;
+            long double t = sum + y;
+            compensation = (t - sum) - y;
+            sum = t;
+        }
+        return static_cast<double>(sum);
+    }
+
+    // Dimensions spread over six decades, so naive sums lose digits
+    std::vector<double> dimensions(size_t count, std::mt19937_64& rng){
+        std::uniform_real_distribution<double> exponent(-3.0, 3.0);
+        std::vector<double> values(count);
+        for (double& value : values) value = std::pow(10.0, exponent(rng));
+        return values;
+    }
+
+    void checkIsa(ShapeKernels::Isa isa, size_t count){
+        std::string where = std::string(ShapeKernels::isaName(isa)) + ", " + std::to_string(count) + " shapes: ";
+        std::mt19937_64 rng(count);
+        std::vector<double> r = dimensions(count, rng), w = dimensions(count, rng), h = dimensions(count, rng);
+
+        std::vector<double> areas, perimeters, rectAreas, rectPerimeters;
+        for (size_t i = 0; i < count; ++i){
+            Circle circle(r[i]);
+            Rectangle rectangle(w[i], h[i]);
+            areas.push_back(circle.getArea());
+            perimeters.push_back(circle.getPerimeter());
+            rectAreas.push_back(rectangle.getArea());
+            rectPerimeters.push_back(rectangle.getPerimeter());
+        }
+
+        std::vector<double> out(count);
+        ShapeKernels::circleAreas(r.data(), out.data(), count);
+        check(out == areas, where + "circle areas differ from Circle::getArea");
+        ShapeKernels::circlePerimeters(r.data(), out.data(), count);
+        check(out == perimeters, where + "circle perimeters differ from Circle::getPerimeter");
+        ShapeKernels::rectangleAreas(w.data(), h.data(), out.data(), count);
+        check(out == rectAreas, where + "rectangle areas differ from Rectangle::getArea");
+        ShapeKernels::rectanglePerimeters(w.data(), h.data(), out.data(), count);
+        check(out == rectPerimeters, where + "rectangle perimeters differ from Rectangle::getPerimeter");
+
+        auto withinBound = [&](double total, const std::vector<double>& values, const char* what){
+            std::int64_t ulps = ulpDistance(total, referenceSum(values));
+            check(ulps <= ShapeKernels::SUM_ULP_BOUND, where + what + " is " + std::to_string(ulps) + " ulps off");
+        };
+        withinBound(ShapeKernels::sumCircleAreas(r.data(), count), areas, "sumCircleAreas");
+        withinBound(ShapeKernels::sumCirclePerimeters(r.data(), count), perimeters, "sumCirclePerimeters");
+        withinBound(ShapeKernels::sumRectangleAreas(w.data(), h.data(), count), rectAreas, "sumRectangleAreas");
+        withinBound(ShapeKernels::sumRectanglePerimeters(w.data(), h.data(), count), rectPerimeters, "sumRectanglePerimeters");
+        withinBound(ShapeKernels::sum(areas.data(), count), areas, "sum");
+    }
+}
+
+int main(){
+    const ShapeKernels::Isa original = ShapeKernels::activeIsa();
+    for (ShapeKernels::Isa isa : {ShapeKernels::Isa::SCALAR, ShapeKernels::Isa::SSE2,
+                                  ShapeKernels::Isa::AVX2, ShapeKernels::Isa::AVX512}){
+        if (!ShapeKernels::useIsa(isa)){
+            std::cout << ShapeKernels::isaName(isa) << " not supported here, skipped" << std::endl;
+            continue;
+        }
+        // Odd counts leave a scalar tail behind every vector width
+        for (size_t count : {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 33, 1000, 100003})
+            checkIsa(isa, count);
+    }
+
+    // Many tiny values after one huge one: a plain running sum drops every tiny one
+    std::vector<double> skewed(100001, 1e-8);
+    skewed[0] = 1e8;
+    for (ShapeKernels::Isa isa : {ShapeKernels::Isa::SCALAR, ShapeKernels::Isa::SSE2,
+                                  ShapeKernels::Isa::AVX2, ShapeKernels::Isa::AVX512}){
+        if (!ShapeKernels::useIsa(isa)) continue;
+        std::int64_t ulps = ulpDistance(ShapeKernels::sum(skewed.data(), skewed.size()), referenceSum(skewed));
+        check(ulps <= ShapeKernels::SUM_ULP_BOUND, std::string(ShapeKernels::isaName(isa)) + ": skewed sum is "
+              + std::to_string(ulps) + " ulps off");
+    }
+    ShapeKernels::useIsa(original);
+    return test::finish("shape_kernels_test");
+}
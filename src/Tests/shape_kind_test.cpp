@@ -0,0 +1,76 @@
+// Shape kind tests
+// Checks that every shape reports the kind and kind name matching its
+// getName(), that shapes from outside the library fall into OTHER, and that
+// printInfo still prints a subclass's own name.
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "CachedShape.h"
+#include "GeometryUtils.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    // A shape the library does not know, with a name of its own
+    class Triangle : public Shape{
+    public:
+        double getArea() const override { return 6.0; }
+        double getPerimeter() const override { return 12.0; }
+        std::string getName() const override { return "Triangle"; }
+    };
+
+    // printInfo's output
+    std::string printed(const Shape& shape){
+        std::ostringstream out;
+        std::streambuf* previous = std::cout.rdbuf(out.rdbuf());
+        shape.printInfo();
+        std::cout.rdbuf(previous);
+        return out.str();
+    }
+}
+
+static_assert(kindName(ShapeKind::SQUARE) == "Square", "kind names are usable at compile time");
+static_assert(kindIndex(ShapeKind::OTHER) == SHAPE_KIND_COUNT - 1, "kinds are dense");
+
+int main(){
+    std::vector<std::unique_ptr<Shape>> shapes;
+    shapes.push_back(std::make_unique<Circle>(1.0));
+    shapes.push_back(std::make_unique<Rectangle>(2.0, 3.0));
+    shapes.push_back(std::make_unique<Rectangle>(2.0, 2.0));
+    shapes.push_back(std::make_unique<CachedCircle>(1.5));
+    shapes.push_back(std::make_unique<CachedRectangle>(4.0, 4.0));
+
+    // Library shapes: the kind name is exactly getName(), without building a string
+    bool matches = true;
+    for (const auto& shape : shapes)
+        matches = matches && shape->getKindName() == shape->getName() && kindName(shape->getKind()) == shape->getName();
+    check(matches, "kind names match getName()");
+    check(shapes[2]->getKind() == ShapeKind::SQUARE && shapes[1]->getKind() == ShapeKind::RECTANGLE,
+          "equal sides make a square");
+
+    // A resized rectangle changes kind with its sides
+    Rectangle& changing = static_cast<Rectangle&>(*shapes[1]);
+    changing.setDimensions(3.0, 3.0);
+    check(changing.getKind() == ShapeKind::SQUARE && changing.getKindName() == "Square", "resized into a square");
+
+    // Shapes from outside the library keep their name but group as OTHER
+    Triangle triangle;
+    check(triangle.getKind() == ShapeKind::OTHER && triangle.getKindName() == "Shape", "unknown shapes are OTHER");
+    check(printed(triangle).find("Shape: Triangle |") == 0, "printInfo prints the subclass name");
+    check(printed(*shapes[0]).find("Shape: Circle |") == 0, "printInfo prints Circle");
+
+    shapes.push_back(std::make_unique<Triangle>());
+    GeometryUtils::KindTable table = GeometryUtils::groupByKind(shapes);
+    check(table[kindIndex(ShapeKind::CIRCLE)].count == 2 && table[kindIndex(ShapeKind::SQUARE)].count == 3
+          && table[kindIndex(ShapeKind::RECTANGLE)].count == 0 && table[kindIndex(ShapeKind::OTHER)].count == 1,
+          "groupByKind counts");
+    check(table[kindIndex(ShapeKind::OTHER)].totalArea == 6.0 && table[kindIndex(ShapeKind::OTHER)].maxPerimeter == 12.0,
+          "groupByKind totals for OTHER");
+    return test::finish("shape_kind_test");
+}
@@ -0,0 +1,123 @@
+// Shape parser tests
+// Feeds ShapeFactory::createFromDescriptions good and bad text, small and
+// larger than one parse chunk, and checks the shapes it adds, the line number
+// it reports for a bad line, and that a failed import adds nothing.
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "ShapeFactory.h"
+#include "ShapeStore.h"
+#include "ThreadPool.h"
+#include "test_check.h"
+
+namespace {
+    const char* PATH = "shape_parser_test.txt";
+
+    using test::check;
+
+    // Message of the std::invalid_argument text throws, empty if it imports
+    std::string importError(const std::string& text, ShapeStore& store, ThreadPool& pool){
+        try{
+            ShapeFactory::createFromDescriptions(store, text, pool);
+        }
+        catch (const std::invalid_argument& e){
+            return e.what();
+        }
+        return "";
+    }
+
+    // Expect line of text to be reported with message
+    void expectError(const std::string& text, const std::string& expected, ThreadPool& pool){
+        ShapeStore store;
+        store.addCircle(1.0);
+        std::string error = importError(text, store, pool);
+        check(error == expected, "expected \"" + expected + "\", got \"" + error + "\"");
+        check(store.size() == 1, "a failed import added shapes (" + expected + ")");
+    }
+
+    // Lines enough to span several parse chunks, alternating circles and rectangles
+    std::string bigText(size_t lines){
+        std::string text;
+        for (size_t i = 0; i < lines; ++i){
+            if (i % 2 == 0)
+                text += "circle " + std::to_string(1 + i % 97) + ".5\n";
+            else
+                text += "rectangle " + std::to_string(1 + i % 13) + " " + std::to_string(2 + i % 7) + "\n";
+        }
+        return text;
+    }
+}
+
+int main(){
+    ThreadPool single(1);
+    ThreadPool several(4);
+
+    // Blanks, tabs, CRLF and blank lines are accepted; the last line needs no newline
+    {
+        ShapeStore store;
+        size_t added = ShapeFactory::createFromDescriptions(store,
+            "circle 2\n\n  rectangle\t3 4\r\n   \ncircle 1e-3\r\nrectangle 5 5", single);
+        check(added == 4 && store.circleCount() == 2 && store.rectangleCount() == 2, "mixed whitespace import");
+        check(store.getRadii()[0] == 2.0 && store.getRadii()[1] == 1e-3, "circle radii");
+        check(store.getWidths()[0] == 3.0 && store.getHeights()[0] == 4.0 && store.getWidths()[1] == 5.0,
+              "rectangle dimensions");
+        check(ShapeFactory::createFromDescriptions(store, "", single) == 0, "empty text adds nothing");
+    }
+
+    // Every kind of bad line is reported with its 1-based line number
+    expectError("circle 1\nsquare 2\n", "Line 2: Unknown shape: square", single);
+    expectError("circle\n", "Line 1: Missing number", single);
+    expectError("circle 1\n\nrectangle 2\n", "Line 3: Missing number", single);
+    expectError("circle 3.5x\n", "Line 1: Invalid number: 3.5x", single);
+    expectError("circle 1\ncircle inf\n", "Line 2: Invalid number: inf", single);
+    expectError("circle 1\ncircle nan\n", "Line 2: Invalid number: nan", single);
+    expectError("circle -2\n", "Line 1: Radius must be positive", single);
+    expectError("circle 1\r\nrectangle 2 0\r\n", "Line 2: Dimensions must be positive", single);
+
+    // Text over several chunks gives the same shapes on any thread count
+    const size_t LINES = 120000;
+    std::string text = bigText(LINES);
+    ShapeStore serial, parallel;
+    check(ShapeFactory::createFromDescriptions(serial, text, single) == LINES, "large import count");
+    ShapeFactory::createFromDescriptions(parallel, text, several);
+    check(serial.getRadii() == parallel.getRadii() && serial.getWidths() == parallel.getWidths()
+          && serial.getHeights() == parallel.getHeights(), "large import depends on the thread count");
+
+    // Line numbers count across chunks; the first bad line in file order wins
+    std::string broken = text;
+    broken.replace(broken.rfind("circle"), 6, "circus");
+    check(text.size() > 1 << 20, "large text spans more than one parse chunk");
+    expectError(broken, "Line " + std::to_string(LINES - 1) + ": Unknown shape: circus", several);
+    broken.replace(broken.find("rectangle", 20000), 9, "rectangel");
+    size_t firstBad = 0;
+    for (size_t at = 0; at < broken.find("rectangel"); ++at)
+        if (broken[at] == '\n') ++firstBad;
+    expectError(broken, "Line " + std::to_string(firstBad + 1) + ": Unknown shape: rectangel", several);
+    expectError(broken, "Line " + std::to_string(firstBad + 1) + ": Unknown shape: rectangel", single);
+
+    // The file version reads the same text through a mapping
+    {
+        std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+    ShapeStore fromFile;
+    check(ShapeFactory::createFromDescriptionFile(fromFile, PATH, several) == LINES
+          && fromFile.getRadii() == serial.getRadii(), "file import matches text import");
+    std::remove(PATH);
+    bool missing = false;
+    try{
+        ShapeFactory::createFromDescriptionFile(fromFile, PATH, several);
+    }
+    catch (const std::runtime_error&){
+        missing = true;
+    }
+    check(missing, "a missing file is reported as std::runtime_error");
+
+    // Single descriptions use the same parser
+    ShapeStore one;
+    check(ShapeFactory::createFromDescription(one, "rectangle 2 3") == 0
+          && one.getHeights()[0] == 3.0, "single description");
+    return test::finish("shape_parser_test");
+}
@@ -0,0 +1,141 @@
+// Shape statistics tests
+// Checks ShapeSummary against a two-pass long double reference, that merging
+// summaries of the parts (Chan et al.) matches summarizing the whole, and that
+// the parallel summaries are the same on any thread count.
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "GeometryUtils.h"
+#include "ShapeStore.h"
+#include "ThreadPool.h"
+#include "test_check.h"
+
+namespace {
+    using GeometryUtils::ShapeSummary;
+    using test::check;
+
+    bool close(double a, double b, double relative){
+        return std::fabs(a - b) <= relative * std::fmax(std::fabs(a), std::fabs(b));
+    }
+
+    // Mean and population variance of the areas, two passes in long double
+    void reference(const std::vector<std::unique_ptr<Shape>>& shapes, double& mean, double& variance){
+        long double sum = 0.0L;
+        for (const auto& shape : shapes) sum += shape->getArea();
+        long double m = sum / shapes.size();
+        long double squares = 0.0L;
+        for (const auto& shape : shapes){
+            long double d = shape->getArea() - m;
+            squares += d * d;
+        }
+        mean = static_cast<double>(m);
+        variance = static_cast<double>(squares / shapes.size());
+    }
+
+    // Same counts, extremes and histogram, totals and moments within relative
+    bool sameSummary(const ShapeSummary& a, const ShapeSummary& b, double relative){
+        return a.count == b.count && a.minArea == b.minArea && a.maxArea == b.maxArea
+               && a.maxPerimeter == b.maxPerimeter && a.kindCounts == b.kindCounts
+               && a.areaHistogram == b.areaHistogram
+               && close(a.totalArea, b.totalArea, relative) && close(a.totalPerimeter, b.totalPerimeter, relative)
+               && close(a.areaMean, b.areaMean, relative) && close(a.areaVariance(), b.areaVariance(), relative);
+    }
+
+    bool identical(const ShapeSummary& a, const ShapeSummary& b){
+        return sameSummary(a, b, 0.0) && a.areaM2 == b.areaM2;
+    }
+
+    // Summary of shapes[first, last)
+    ShapeSummary summarizePart(const std::vector<std::unique_ptr<Shape>>& shapes, size_t first, size_t last){
+        ShapeSummary summary;
+        for (size_t i = first; i < last; ++i)
+            summary.add(shapes[i]->getKind(), shapes[i]->getArea(), shapes[i]->getPerimeter());
+        return summary;
+    }
+}
+
+int main(){
+    // Large areas with a small spread: a naive sum of squares would cancel to noise
+    std::mt19937_64 rng(24);
+    std::uniform_real_distribution<double> jitter(0.0, 1.0);
+    std::vector<std::unique_ptr<Shape>> shapes;
+    ShapeStore store;
+    for (int i = 0; i < 30000; ++i){
+        double r = 1000.0 + jitter(rng);
+        shapes.push_back(std::make_unique<Circle>(r));
+        store.addCircle(r);
+    }
+    for (int i = 0; i < 20000; ++i){
+        double w = 1700.0 + jitter(rng);
+        double h = i % 4 == 0 ? w : 1800.0 + jitter(rng);
+        shapes.push_back(std::make_unique<Rectangle>(w, h));
+        store.addRectangle(w, h);
+    }
+
+    ShapeSummary whole = GeometryUtils::summarize(shapes);
+    double mean, variance;
+    reference(shapes, mean, variance);
+    check(whole.count == shapes.size(), "summary count");
+    check(close(whole.areaMean, mean, 1e-14) && close(whole.meanArea(), mean, 1e-12), "mean matches the reference");
+    check(close(whole.areaVariance(), variance, 1e-9), "variance matches the reference: " + std::to_string(whole.areaVariance())
+          + " vs " + std::to_string(variance));
+    check(whole.kindCounts[kindIndex(ShapeKind::CIRCLE)] == 30000 && whole.squareCount() == 5000
+          && whole.kindCounts[kindIndex(ShapeKind::RECTANGLE)] == 15000, "kind counts");
+    size_t binned = 0;
+    for (size_t count : whole.areaHistogram) binned += count;
+    check(binned == whole.count, "every area lands in one bin");
+
+    // Parts merged in order match the whole, however the parts are cut
+    for (size_t parts : {2, 3, 7, 64}){
+        ShapeSummary merged;
+        for (size_t p = 0; p < parts; ++p)
+            merged.merge(summarizePart(shapes, shapes.size() * p / parts, shapes.size() * (p + 1) / parts));
+        check(sameSummary(merged, whole, 1e-9), "merging " + std::to_string(parts) + " parts differs from the whole");
+    }
+
+    // Uneven parts, including one shape and nothing at all
+    ShapeSummary uneven = summarizePart(shapes, 0, 1);
+    uneven.merge(ShapeSummary());
+    uneven.merge(summarizePart(shapes, 1, 40000));
+    uneven.merge(summarizePart(shapes, 40000, shapes.size()));
+    check(sameSummary(uneven, whole, 1e-9), "merging uneven parts differs from the whole");
+    ShapeSummary empty;
+    empty.merge(whole);
+    check(identical(empty, whole), "merging into an empty summary copies it");
+    ShapeSummary copy = whole;
+    copy.merge(ShapeSummary());
+    check(identical(copy, whole), "merging an empty summary changes nothing");
+
+    // Parallel summaries merge chunks in chunk order, so the thread count never shows
+    ThreadPool single(1);
+    ThreadPool several(4);
+    ShapeSummary parallelOne = GeometryUtils::parallelSummarize(shapes, single);
+    ShapeSummary parallelFour = GeometryUtils::parallelSummarize(shapes, several);
+    check(identical(parallelOne, parallelFour), "parallelSummarize depends on the thread count");
+    check(sameSummary(parallelOne, whole, 1e-9), "parallelSummarize differs from summarize");
+    check(identical(GeometryUtils::parallelSummarize(store, single), GeometryUtils::parallelSummarize(store, several)),
+          "parallelSummarize of a store depends on the thread count");
+
+    // A store holds the same shapes, circles first, so its summary matches
+    check(sameSummary(GeometryUtils::summarize(store), whole, 1e-9), "store summary differs from the objects'");
+
+    // Fixed bin edges, with everything out of range in the end bins
+    check(ShapeSummary::areaBin(0.0) == 0 && ShapeSummary::areaBin(std::nan("")) == 0
+          && ShapeSummary::areaBin(1.0 / 1024) == 0, "small areas land in the first bin");
+    check(ShapeSummary::areaBin(1.0) == 8 && ShapeSummary::areaBin(1.5) == 8 && ShapeSummary::areaBin(2.0) == 9,
+          "power-of-two bin edges");
+    check(ShapeSummary::areaBin(1e30) == ShapeSummary::AREA_BINS - 1
+          && ShapeSummary::areaBin(std::numeric_limits<double>::infinity()) == ShapeSummary::AREA_BINS - 1,
+          "large areas land in the last bin");
+
+    ShapeSummary none = GeometryUtils::summarize(std::vector<std::unique_ptr<Shape>>());
+    check(none.count == 0 && none.meanArea() == 0.0 && none.areaVariance() == 0.0 && none.minArea == 0.0,
+          "empty summary");
+    return test::finish("shape_stats_test");
+}
@@ -0,0 +1,95 @@
+// Shape store tests
+// Checks that a ShapeStore validates like Circle and Rectangle, adds all or
+// nothing from raw columns, and that its column kernels agree with the same
+// shapes held as objects.
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "GeometryUtils.h"
+#include "ShapeFactory.h"
+#include "ShapeStore.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    bool close(double a, double b){
+        return std::fabs(a - b) <= 1e-12 * std::fmax(std::fabs(a), std::fabs(b));
+    }
+
+    // True if action throws std::invalid_argument
+    template<typename Action>
+    bool rejects(Action action){
+        try{
+            action();
+        }
+        catch (const std::invalid_argument&){
+            return true;
+        }
+        return false;
+    }
+}
+
+int main(){
+    ShapeStore store;
+    std::vector<std::unique_ptr<Shape>> objects;
+    for (int i = 1; i <= 3000; ++i){
+        double r = 0.5 + (i % 41) * 0.75;
+        double w = 1.0 + (i % 13);
+        double h = i % 5 == 0 ? w : 0.25 + (i % 29);
+        check(store.addCircle(r) == store.circleCount() - 1, "addCircle returns its row");
+        check(store.addRectangle(w, h) == store.rectangleCount() - 1, "addRectangle returns its row");
+        objects.push_back(std::make_unique<Circle>(r));
+        objects.push_back(std::make_unique<Rectangle>(w, h));
+    }
+    check(store.size() == objects.size() && !store.empty(), "store size");
+
+    // Column kernels agree with the objects; maxima are exact
+    check(close(store.totalArea(), GeometryUtils::totalArea(objects)), "totalArea matches the objects");
+    double perimeters = 0.0;
+    for (const auto& shape : objects) perimeters += shape->getPerimeter();
+    check(close(store.totalPerimeter(), perimeters), "totalPerimeter matches the objects");
+    check(store.largestPerimeter() == GeometryUtils::largestPerimeter(objects)->getPerimeter(), "largestPerimeter is exact");
+    check(GeometryUtils::totalArea(store) == store.totalArea()
+          && GeometryUtils::largestPerimeter(store) == store.largestPerimeter(), "GeometryUtils overloads for stores");
+    ShapeStoreView view = store.view();
+    check(view.size() == store.size() && view.totalArea() == store.totalArea(), "a view runs the same kernels");
+
+    GeometryUtils::KindTable fromStore = GeometryUtils::groupByKind(store);
+    GeometryUtils::KindTable fromObjects = GeometryUtils::groupByKind(objects);
+    bool sameKinds = true;
+    for (size_t k = 0; k < SHAPE_KIND_COUNT; ++k)
+        sameKinds = sameKinds && fromStore[k].count == fromObjects[k].count && fromStore[k].maxArea == fromObjects[k].maxArea;
+    check(sameKinds && fromStore[kindIndex(ShapeKind::SQUARE)].count == 600, "squares are grouped apart");
+
+    // Same validation as the classes, and nothing is added on failure
+    size_t before = store.size();
+    check(rejects([&]{ store.addCircle(0.0); }) && rejects([&]{ store.addRectangle(1.0, -1.0); }),
+          "non-positive dimensions are rejected");
+    double radii[] = {1.0, 2.0, -3.0};
+    double widths[] = {1.0, 2.0};
+    double heights[] = {1.0, 0.0};
+    check(rejects([&]{ store.appendColumns(radii, 3, widths, heights, 0); }), "appendColumns rejects a bad radius");
+    check(rejects([&]{ store.appendColumns(radii, 2, widths, heights, 2); }), "appendColumns rejects a bad height");
+    check(store.size() == before, "a rejected append adds nothing");
+    store.appendColumns(radii, 2, widths, heights, 1);
+    check(store.size() == before + 3 && store.getRadii().back() == 2.0 && store.getWidths().back() == 1.0,
+          "appendColumns adds every column");
+
+    // The factory writes straight into the columns
+    ShapeStore built;
+    ShapeFactory::createShape(built, ShapeFactory::ShapeType::SQUARE, 3.0);
+    ShapeFactory::createFromDescription(built, "circle 2");
+    check(built.rectangleCount() == 1 && built.getHeights()[0] == 3.0 && built.getRadii()[0] == 2.0, "factory into a store");
+
+    ShapeStore combined = built;
+    combined.append(built);
+    check(combined.size() == 4 && combined.totalArea() == 2 * built.totalArea(), "append copies every column");
+    combined.clear();
+    check(combined.empty() && combined.totalArea() == 0.0 && combined.largestPerimeter() == 0.0, "cleared store");
+    return test::finish("shape_store_test");
+}
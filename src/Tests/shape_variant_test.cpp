@@ -0,0 +1,77 @@
+// Shape variant tests
+// Holds the same shapes as ShapeVariant values and as Shape objects and checks
+// every statically dispatched utility gives exactly the virtual answer.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "GeometryUtils.h"
+#include "ShapeVariant.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+}
+
+int main(){
+    std::vector<ShapeVariant> variants;
+    std::vector<std::unique_ptr<Shape>> objects;
+    for (int i = 0; i < 5000; ++i){
+        double a = 0.5 + i % 23;
+        double b = i % 4 == 0 ? a : 1.5 + i % 31;
+        if (i % 2 == 0){
+            variants.emplace_back(Circle(a));
+            objects.push_back(std::make_unique<Circle>(a));
+        } else {
+            variants.emplace_back(Rectangle(a, b));
+            objects.push_back(std::make_unique<Rectangle>(a, b));
+        }
+    }
+
+    // Per shape: the same formulas, names and kinds as the virtual calls
+    bool same = true;
+    for (size_t i = 0; i < variants.size(); ++i){
+        same = same && getArea(variants[i]) == objects[i]->getArea()
+               && getPerimeter(variants[i]) == objects[i]->getPerimeter()
+               && getName(variants[i]) == objects[i]->getName()
+               && getKind(variants[i]) == objects[i]->getKind()
+               && getKindName(variants[i]) == objects[i]->getKindName();
+    }
+    check(same, "per-shape answers differ from the virtual calls");
+
+    // Collection utilities, evaluated in the same order, give the same bits
+    check(GeometryUtils::totalArea(variants) == GeometryUtils::totalArea(objects), "totalArea");
+    check(GeometryUtils::averageArea(variants) == GeometryUtils::averageArea(objects), "averageArea through ADL");
+    const Shape* largestObject = GeometryUtils::largestPerimeter(objects);
+    auto objectAt = std::find_if(objects.begin(), objects.end(), [largestObject](const auto& shape){
+        return shape.get() == largestObject;
+    });
+    const ShapeVariant* largest = GeometryUtils::largestPerimeter(variants);
+    check(largest == &variants[objectAt - objects.begin()], "largestPerimeter picks the same shape");
+
+    GeometryUtils::KindTable fromVariants = GeometryUtils::groupByKind(variants);
+    GeometryUtils::KindTable fromObjects = GeometryUtils::groupByKind(objects);
+    bool sameKinds = true;
+    for (size_t k = 0; k < SHAPE_KIND_COUNT; ++k){
+        sameKinds = sameKinds && fromVariants[k].count == fromObjects[k].count
+                    && fromVariants[k].totalArea == fromObjects[k].totalArea
+                    && fromVariants[k].maxPerimeter == fromObjects[k].maxPerimeter;
+    }
+    check(sameKinds, "groupByKind");
+
+    GeometryUtils::ShapeSummary a = GeometryUtils::summarize(variants);
+    GeometryUtils::ShapeSummary b = GeometryUtils::summarize(objects);
+    check(a.count == b.count && a.totalArea == b.totalArea && a.areaM2 == b.areaM2
+          && a.kindCounts == b.kindCounts && a.areaHistogram == b.areaHistogram, "summarize");
+
+    // A variant holds its shape by value, so changing it is seen at once
+    std::get<Circle>(variants[0]).setRadius(100.0);
+    check(getArea(variants[0]) == Circle(100.0).getArea(), "changed variant");
+
+    std::vector<ShapeVariant> none;
+    check(GeometryUtils::totalArea(none) == 0.0 && GeometryUtils::largestPerimeter(none) == nullptr
+          && GeometryUtils::averageArea(none) == 0.0, "empty collection");
+    return test::finish("shape_variant_test");
+}
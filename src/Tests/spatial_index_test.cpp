@@ -0,0 +1,186 @@
+// Spatial index tests
+// Answers every query with ShapeBvh, ShapeGrid and a brute-force scan of the
+// same scene and checks all three agree, before and after shapes are resized,
+// moved, added and removed, and with shapes too large for the grid's cells.
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Circle.h"
+#include "Rectangle.h"
+#include "PositionedShape.h"
+#include "ShapeBvh.h"
+#include "ShapeGrid.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    const double CELL_SIZE = 5.0;
+
+    std::vector<size_t> sorted(std::vector<size_t> indices){
+        std::sort(indices.begin(), indices.end());
+        return indices;
+    }
+
+    // Shapes in [0, 200) x [0, 200), a few units across
+    std::vector<PositionedShape> makeScene(size_t count, std::mt19937_64& rng){
+        std::uniform_real_distribution<double> coordinate(0.0, 200.0);
+        std::uniform_real_distribution<double> size(0.1, 5.0);
+        std::vector<PositionedShape> scene;
+        for (size_t i = 0; i < count; ++i){
+            Point at{coordinate(rng), coordinate(rng)};
+            if (i % 2 == 0)
+                scene.emplace_back(std::make_unique<Circle>(size(rng)), at);
+            else
+                scene.emplace_back(std::make_unique<Rectangle>(size(rng), size(rng)), at);
+        }
+        return scene;
+    }
+
+    // Brute-force answers, over the shapes tracked says are in the index
+    template<typename Tracked>
+    std::vector<size_t> scanRegion(const std::vector<PositionedShape>& scene, const Bounds& region, Tracked tracked){
+        std::vector<size_t> out;
+        for (size_t i = 0; i < scene.size(); ++i)
+            if (tracked(i) && scene[i].getBounds().overlaps(region)) out.push_back(i);
+        return out;
+    }
+
+    template<typename Tracked>
+    std::vector<size_t> scanPoint(const std::vector<PositionedShape>& scene, const Point& p, Tracked tracked){
+        std::vector<size_t> out;
+        for (size_t i = 0; i < scene.size(); ++i)
+            if (tracked(i) && scene[i].contains(p)) out.push_back(i);
+        return out;
+    }
+
+    // Run the same random queries on both indexes and the scan
+    void checkQueries(const std::vector<PositionedShape>& scene, const ShapeBvh& bvh, const ShapeGrid& grid,
+                      std::mt19937_64& rng, const std::string& when){
+        auto all = [](size_t){ return true; };
+        auto inGrid = [&grid](size_t i){ return grid.isTracked(i); };
+        std::uniform_real_distribution<double> coordinate(-10.0, 210.0);
+        std::uniform_real_distribution<double> extent(0.0, 30.0);
+        bool regionsAgree = true, pointsAgree = true, overlapsAgree = true;
+        for (int q = 0; q < 200; ++q){
+            Point corner{coordinate(rng), coordinate(rng)};
+            Bounds region{corner.x, corner.y, corner.x + extent(rng), corner.y + extent(rng)};
+            std::vector<size_t> bvhHits, gridHits;
+            bvh.findInRegion(region, bvhHits);
+            grid.findInRegion(region, gridHits);
+            regionsAgree = regionsAgree && sorted(bvhHits) == scanRegion(scene, region, all)
+                           && sorted(gridHits) == scanRegion(scene, region, inGrid);
+
+            Point p{coordinate(rng), coordinate(rng)};
+            bvhHits.clear();
+            gridHits.clear();
+            bvh.findAtPoint(p, bvhHits);
+            grid.findAtPoint(p, gridHits);
+            pointsAgree = pointsAgree && sorted(bvhHits) == scanPoint(scene, p, all)
+                          && sorted(gridHits) == scanPoint(scene, p, inGrid);
+        }
+        for (size_t i = 0; i < scene.size(); i += 37){
+            std::vector<size_t> expected = scanRegion(scene, scene[i].getBounds(), all);
+            expected.erase(std::remove(expected.begin(), expected.end(), i), expected.end());
+            std::vector<size_t> bvhHits;
+            bvh.findOverlapping(i, bvhHits);
+            overlapsAgree = overlapsAgree && sorted(bvhHits) == expected;
+            if (grid.isTracked(i)){
+                std::vector<size_t> gridHits;
+                grid.findOverlapping(i, gridHits);
+                expected = scanRegion(scene, scene[i].getBounds(), inGrid);
+                expected.erase(std::remove(expected.begin(), expected.end(), i), expected.end());
+                overlapsAgree = overlapsAgree && sorted(gridHits) == expected;
+            }
+        }
+        check(regionsAgree, when + ": findInRegion differs from a scan");
+        check(pointsAgree, when + ": findAtPoint differs from a scan");
+        check(overlapsAgree, when + ": findOverlapping differs from a scan");
+    }
+}
+
+int main(){
+    std::mt19937_64 rng(23);
+    std::vector<PositionedShape> scene = makeScene(2000, rng);
+    ShapeBvh bvh(scene);
+    ShapeGrid grid(scene, CELL_SIZE);
+    check(bvh.size() == scene.size() && grid.size() == scene.size(), "every shape indexed");
+    check(!bvh.isStale() && !grid.isStale(), "fresh indexes are not stale");
+    checkQueries(scene, bvh, grid, rng, "after build");
+
+    // Resizing is noticed; update() fixes one shape, refit() the rest
+    static_cast<Circle&>(*scene[0].shape).setRadius(12.0);
+    static_cast<Rectangle&>(*scene[1].shape).setDimensions(0.5, 40.0);
+    static_cast<Circle&>(*scene[2].shape).setRadius(0.2);
+    check(bvh.isStale() && grid.isStale(), "resizing makes both indexes stale");
+    bvh.update(0);
+    grid.update(0);
+    check(bvh.isStale() && grid.isStale(), "updating one of three resized shapes leaves them stale");
+    check(bvh.refit() == 2 && grid.refit() == 2, "refit finds the two shapes update() did not see");
+    check(!bvh.isStale() && !grid.isStale(), "refit clears staleness");
+    checkQueries(scene, bvh, grid, rng, "after resizing");
+
+    // Moves are plain data: nothing goes stale, update() and refit() pick them up
+    std::uniform_real_distribution<double> coordinate(0.0, 200.0);
+    for (size_t i = 0; i < scene.size(); i += 5)
+        scene[i].position = Point{coordinate(rng), coordinate(rng)};
+    check(!bvh.isStale() && !grid.isStale(), "moves do not make an index stale");
+    for (size_t i = 0; i < scene.size(); i += 10){
+        bvh.update(i);
+        grid.update(i);
+    }
+    bvh.refit();
+    grid.refit();
+    checkQueries(scene, bvh, grid, rng, "after moving");
+
+    // Shapes far larger than a cell stay out of the cells and are found once
+    size_t huge = scene.size();
+    scene.emplace_back(std::make_unique<Circle>(1e5), Point{100.0, 100.0});
+    scene.emplace_back(std::make_unique<Rectangle>(1e6, 1.0), Point{100.0, 50.0});
+    scene.emplace_back(std::make_unique<Circle>(1e300), Point{});
+    size_t cellsBefore = grid.getCellCount();
+    for (size_t i = huge; i < scene.size(); ++i)
+        grid.insert(i);
+    check(bvh.refit() == scene.size(), "refit rebuilds once shapes were appended");
+    check(grid.getLargeCount() == 3 && grid.getCellCount() == cellsBefore, "large shapes are kept out of the cells");
+    checkQueries(scene, bvh, grid, rng, "with large shapes");
+
+    // A large shape shrinking back goes into the cells, and removed shapes are never reported
+    static_cast<Circle&>(*scene[huge].shape).setRadius(1.0);
+    grid.update(huge);
+    bvh.update(huge);
+    check(grid.getLargeCount() == 2, "a shrunk large shape is filed in cells");
+    for (size_t i = 0; i < scene.size(); i += 3)
+        grid.remove(i);
+    grid.remove(0);
+    check(!grid.isTracked(0) && grid.size() == scene.size() - (scene.size() + 2) / 3, "removed shapes are not tracked");
+    checkQueries(scene, bvh, grid, rng, "after removing from the grid");
+
+    // A resized shape outside the index does not make it stale
+    std::vector<PositionedShape> other = makeScene(10, rng);
+    static_cast<Circle&>(*other[0].shape).setRadius(3.0);
+    check(!bvh.isStale() && !grid.isStale(), "shapes of another scene do not make an index stale");
+
+    // Empty scenes answer nothing
+    std::vector<PositionedShape> empty;
+    ShapeBvh emptyBvh(empty);
+    ShapeGrid emptyGrid(empty, CELL_SIZE);
+    std::vector<size_t> hits;
+    check(emptyBvh.findInRegion(Bounds{-1, -1, 1, 1}, hits) == 0 && emptyGrid.findAtPoint(Point{}, hits) == 0,
+          "empty scene has no hits");
+    check(emptyBvh.getBounds().empty(), "empty scene has empty bounds");
+
+    bool rejected = false;
+    try{
+        ShapeGrid bad(scene, 0.0);
+    }
+    catch (const std::invalid_argument&){
+        rejected = true;
+    }
+    check(rejected, "cell size 0 is rejected");
+    return test::finish("spatial_index_test");
+}
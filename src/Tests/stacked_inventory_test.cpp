@@ -0,0 +1,95 @@
+// Stacked inventory tests
+// Checks that units spread over as many stacks as their limit needs, that the
+// capacity counts stacks, that changing a limit restacks without dropping
+// units, and that indexing and rendering show one entry per stack.
+
+#include <climits>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "stacked_inventory.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    // Text rendering of every stack
+    std::string rendered(const StackedInventory& inventory_i){
+        RenderBuffer out;
+        inventory_i.render(out, RenderFormat::TEXT, "Bag");
+        return std::string(out.view());
+    }
+
+    // What running action prints
+    template<typename Action>
+    std::string printed(Action action_i){
+        std::ostringstream out;
+        std::streambuf* previous = std::cout.rdbuf(out.rdbuf());
+        action_i();
+        std::cout.rdbuf(previous);
+        return out.str();
+    }
+}
+
+int main(){
+    ItemRegistry registry;
+
+    // Units past the limit open more stacks, and the capacity counts stacks
+    StackedInventory bag(3, 20, registry);
+    check(bag.addUnits("Potion", 45) == 45 && bag.getStackCount() == 3 && bag.getItemCount() == 45,
+          "45 units at 20 per stack take 3 stacks");
+    check(bag.addUnits("Potion", 30) == 15 && bag.getQuantity("Potion") == 60, "adding stops when every stack is full");
+    check(bag.addUnits("Arrow", 1) == 0 && bag.getQuantity("Arrow") == 0, "no free stack for another item");
+    check(rendered(bag) == "Bag: [ Potion x20, Potion x20, Potion x20 ]\n", "full stacks render first");
+
+    // Removing frees stacks, which any item can then use
+    check(bag.removeUnits("Potion", 25) == 25 && bag.getStackCount() == 2, "removing frees a stack");
+    check(bag.addUnits("Arrow", 5) == 5 && bag.getStackCount() == 3, "a freed stack takes another item");
+    check(bag[0] == "Potion" && bag[1] == "Potion" && bag[2] == "Arrow" && bag[3] == "Index out of bounds"
+          && bag[-1] == "Index out of bounds", "operator[] walks the stacks");
+    check(rendered(bag) == "Bag: [ Potion x20, Potion x15, Arrow x5 ]\n", "render after removing");
+    check(bag.removeUnits("Ghost", 1) == 0 && bag.removeUnits("Arrow", 0) == 0 && bag.addUnits("Arrow", -2) == 0,
+          "missing items and non-positive quantities change nothing");
+
+    // An emptied item gives its place to the last item
+    check(bag.removeUnits("Potion", 100) == 35 && bag.getQuantity("Potion") == 0 && bag.getStackCount() == 1,
+          "removing more than held takes what is there");
+    check(bag[0] == "Arrow" && rendered(bag) == "Bag: [ Arrow x5 ]\n", "emptied item is gone");
+
+    // A lower limit restacks held units and can leave the inventory over capacity
+    StackedInventory pack(4, 10, registry);
+    pack.addUnits("Gem", 30);
+    pack.setStackLimit("Gem", 5);
+    check(pack.getQuantity("Gem") == 30 && pack.getStackCount() == 6 && pack.getStackLimit(registry.intern("Gem")) == 5,
+          "restacking keeps every unit");
+    check(pack.addUnits("Gem", 1) == 0 && pack.addUnits("Rope", 1) == 0, "over capacity nothing can be added");
+    pack.removeUnits("Gem", 15);
+    check(pack.getStackCount() == 3 && pack.addUnits("Gem", 10) == 5, "back under capacity the free stack fills");
+    pack.setStackLimit("Gem", 100);
+    check(pack.getStackCount() == 1 && pack.addUnits("Rope", 1) == 1, "a higher limit merges stacks");
+
+    // A limit of 0 takes no new units, and held ones count one per stack
+    pack.setStackLimit("Rope", 0);
+    check(pack.addUnits("Rope", 3) == 0 && pack.getQuantity("Rope") == 1, "limit 0 adds nothing");
+    pack.setStackLimit("Gem", 0);
+    check(pack.getStackCount() == 21 && rendered(pack).find("Gem, Gem") != std::string::npos, "limit 0 keeps one unit per stack");
+    pack.removeUnits("Gem", 20);
+    check(pack.getStackCount() == 1 && pack[0] == "Rope", "removing every unit of an item");
+
+    // The default limit of INT_MAX keeps one stack and cannot overflow the count
+    StackedInventory chest(1, INT_MAX, registry);
+    check(chest.addUnits("Coin", INT_MAX) == INT_MAX && chest.getStackCount() == 1, "INT_MAX units in one stack");
+    check(chest.addUnits("Coin", 1) == 0 && chest.getQuantity("Coin") == INT_MAX, "a full INT_MAX stack takes no more");
+    StackedInventory unlimited(2);
+    check(unlimited.addUnits("Stone", 1000000) == 1000000 && unlimited.getStackCount() == 1, "default limit is unlimited");
+
+    // The printing operators add and remove one unit
+    StackedInventory pouch(1, 2, registry);
+    pouch += "Seed"; pouch += "Seed";
+    std::string full = printed([&pouch]{ pouch += "Seed"; });
+    std::string missing = printed([&pouch]{ pouch -= "Leaf"; });
+    pouch -= "Seed";
+    check(full == "Inventory is full, cannot add Seed\n" && missing == "Item Leaf not found in inventory\n"
+          && pouch.getQuantity("Seed") == 1, "operators");
+    return test::finish("stacked_inventory_test");
+}
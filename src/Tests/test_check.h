@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+#include <string>
+
+// Minimal checks shared by the tests: a failed check is printed and counted,
+// and the test keeps going so one run reports every failure
+namespace test{
+    inline int failures = 0;
+
+    // Record a failure if condition is false
+    inline void check(bool condition, const std::string& what){
+        if (!condition){
+            std::cout << "FAIL: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    // Print the outcome and return the process exit code
+    inline int finish(const std::string& name){
+        if (failures == 0)
+            std::cout << name << ": all checks passed" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+#endif // TEST_CHECK_H
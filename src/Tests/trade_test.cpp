@@ -0,0 +1,113 @@
+// Trade tests
+// Checks that a trade either moves every offered item or changes nothing,
+// reports why it was rejected, interns names only on completion, works
+// between inventories with different registries, and keeps items whole
+// when many threads trade over the same inventories.
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "inventory.h"
+#include "trade.h"
+#include "test_check.h"
+
+namespace {
+    using test::check;
+
+    // The inventory's items in index order
+    std::vector<std::string> itemsOf(const Inventory& inventory_i){
+        return std::vector<std::string>(inventory_i.begin(), inventory_i.end());
+    }
+
+    // Copies of one name an inventory holds
+    int copiesOf(const Inventory& inventory_i, const std::string& name_i){
+        std::optional<ItemId> id = inventory_i.getRegistry().lookup(name_i);
+        return id ? inventory_i.countOf(*id) : 0;
+    }
+}
+
+int main(){
+    ItemRegistry registry;
+
+    // A completed trade moves both ways; received items go to the end
+    Inventory left(5, RemovalPolicy::LINEAR, registry);
+    Inventory right(5, RemovalPolicy::TOMBSTONE, registry);
+    left.addItems({"sword", "shield", "potion"});
+    right.addItems({"gold", "gold", "map"});
+    TradeResult result = Trade(left, right).give("sword").give("potion").take("gold").take("gold").execute();
+    check(result == TradeResult::COMPLETED, "a valid trade completes");
+    check(itemsOf(left) == std::vector<std::string>({"shield", "gold", "gold"})
+          && itemsOf(right) == std::vector<std::string>({"map", "sword", "potion"}), "items moved both ways");
+
+    // A missing item rejects the whole trade, and nothing changes on either side
+    std::vector<std::string> leftBefore = itemsOf(left), rightBefore = itemsOf(right);
+    check(Trade(left, right).give("shield").take("map").take("lantern").execute() == TradeResult::MISSING_ITEM,
+          "an item the giver does not hold");
+    check(Trade(left, right).give("gold").give("gold").give("gold").execute() == TradeResult::MISSING_ITEM,
+          "more copies than the giver holds");
+    check(itemsOf(left) == leftBefore && itemsOf(right) == rightBefore, "a rejected trade changes nothing");
+
+    // Capacity is checked for the net change on each side
+    Inventory small(3, RemovalPolicy::SWAP_AND_POP, registry);
+    small.addItems({"rock", "rock", "rock"});
+    check(Trade(small, right).take("map").execute() == TradeResult::LEFT_FULL, "left would overflow");
+    check(Trade(right, small).give("map").execute() == TradeResult::RIGHT_FULL, "right would overflow");
+    check(Trade(small, right).give("rock").take("map").execute() == TradeResult::COMPLETED
+          && copiesOf(small, "map") == 1 && copiesOf(small, "rock") == 2 && copiesOf(right, "rock") == 1,
+          "a full inventory can swap one for one");
+    check(Trade(left, small).execute() == TradeResult::COMPLETED && itemsOf(left) == leftBefore, "an empty trade");
+
+    // A rejected trade interns nothing in the receiving registry
+    ItemRegistry otherWorld;
+    Inventory visitor(5, RemovalPolicy::LINEAR, otherWorld);
+    visitor.addItems({"amulet"});
+    size_t known = otherWorld.size();
+    check(Trade(left, visitor).give("shield").give("crown").execute() == TradeResult::MISSING_ITEM
+          && !otherWorld.lookup("shield") && otherWorld.size() == known, "rejected names are not interned");
+
+    // Trades across registries resolve names on each side
+    check(Trade(left, visitor).give("shield").take("amulet").execute() == TradeResult::COMPLETED, "cross-registry trade");
+    check(itemsOf(visitor) == std::vector<std::string>({"shield"}) && copiesOf(left, "amulet") == 1
+          && otherWorld.lookup("shield").has_value(), "names are interned in the receiver's registry");
+
+    // An inventory cannot trade with itself
+    bool rejected = false;
+    try{
+        Trade(left, left);
+    }
+    catch (const std::invalid_argument&){
+        rejected = true;
+    }
+    check(rejected, "a self-trade throws std::invalid_argument");
+
+    // Threads passing coins around a ring of shared inventories never lose or copy one
+    const int SIDES = 4, COINS = 50, ROUNDS = 2000;
+    std::vector<Inventory> ring;
+    ring.reserve(SIDES);
+    for (int i = 0; i < SIDES; ++i){
+        ring.emplace_back(SIDES * COINS, i % 2 == 0 ? RemovalPolicy::SWAP_AND_POP : RemovalPolicy::TOMBSTONE, registry);
+        for (int c = 0; c < COINS; ++c) ring.back().addItems({"coin"});
+    }
+    std::vector<std::thread> traders;
+    std::vector<int> completed(SIDES, 0);
+    for (int t = 0; t < SIDES; ++t){
+        traders.emplace_back([&ring, &completed, t]{
+            for (int round = 0; round < ROUNDS; ++round){
+                Inventory& from = ring[t];
+                Inventory& to = ring[(t + 1 + round % (SIDES - 1)) % SIDES];
+                if (Trade(from, to).give("coin").execute() == TradeResult::COMPLETED) ++completed[t];
+            }
+        });
+    }
+    for (auto& trader : traders) trader.join();
+    int coins = 0, total = 0;
+    for (const Inventory& side : ring){
+        coins += copiesOf(side, "coin");
+        total += side.getItemCount();
+    }
+    int trades = 0;
+    for (int count : completed) trades += count;
+    check(coins == SIDES * COINS && total == SIDES * COINS && trades > 0, "concurrent trades conserve items");
+    return test::finish("trade_test");
+}